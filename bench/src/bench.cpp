@@ -0,0 +1,38 @@
+#include "bench.h"
+
+#ifdef NRF_UART_HOST
+#define BENCH_TARGET "host"
+#else
+#define BENCH_TARGET CONFIG_BOARD
+#endif
+
+namespace bench
+{
+    void Source::OnPoll(uart::MemoryTransport &t)
+    {
+        while(true)
+        {
+            size_t n = t.Feed(m_Data.data() + m_Pos, m_Data.size() - m_Pos);
+            if (!n)
+                break;
+            m_Pos = (m_Pos + n) % m_Data.size();
+        }
+    }
+
+    void Emit(Result const& r)
+    {
+        uint64_t cps = sys_clock_hw_cycles_per_sec();
+        uint64_t cyc = r.cycles ? r.cycles : 1;
+        //integer only: printk may lack float and 64 bit support
+        uint32_t cycPerByte100 = r.bytes ? uint32_t(r.cycles * 100 / r.bytes) : 0;
+        uint32_t cycPerOp = r.ops ? uint32_t(r.cycles / r.ops) : 0;
+        uint32_t opsPerSec = uint32_t(uint64_t(r.ops) * cps / cyc);
+        uint32_t bytesPerSec = uint32_t(uint64_t(r.bytes) * cps / cyc);
+        uint32_t avgNs = r.ops ? uint32_t(r.cycles * 1'000'000'000 / cps / r.ops) : 0;
+        uint32_t maxUs = uint32_t(uint64_t(r.maxCycles) * 1'000'000 / cps);
+        printk("{\"bench\":\"%s\",\"target\":\"%s\",\"ops\":%u,\"fail\":%u,\"bytes\":%u"
+                ",\"cyc_per_byte\":%u.%02u,\"cyc_per_op\":%u,\"ops_per_s\":%u,\"bytes_per_s\":%u,\"avg_ns\":%u,\"max_us\":%u,\"cps\":%u}\n"
+                , r.pName, BENCH_TARGET, r.ops, r.failures, r.bytes
+                , cycPerByte100 / 100, cycPerByte100 % 100, cycPerOp, opsPerSec, bytesPerSec, avgNs, maxUs, uint32_t(cps));
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef NRF_UART_BENCH_H_
+#define NRF_UART_BENCH_H_
+
+#include <nrf_uart/lib_uart.h>
+#include <nrf_uart/lib_uart_memory.h>
+#include <span>
+
+namespace bench
+{
+    /**********************************************************************/
+    /* Source                                                             */
+    /* Endless byte stream: replays the same record(s) on every poll so    */
+    /* the channel never runs dry. Each benchmark op consumes a fixed     */
+    /* number of bytes, which makes cycles per byte exact.                */
+    /**********************************************************************/
+    class Source: public uart::MemoryTransport::Peer
+    {
+    public:
+        Source(std::span<const uint8_t> data): m_Data(data) {}
+
+        void OnTx(uart::MemoryTransport &t, const uint8_t *pData, size_t len) override {}
+        void OnPoll(uart::MemoryTransport &t) override;
+    private:
+        std::span<const uint8_t> m_Data;
+        size_t m_Pos = 0;
+    };
+
+    /**********************************************************************/
+    /* Rig                                                                */
+    /* Transport + source + reading channel (or driver) for one case.     */
+    /**********************************************************************/
+    template<class C = uart::Channel>
+    struct Rig
+    {
+        static constexpr const size_t kStorage = 512;
+
+        uart::MemoryTransportStatic<kStorage> t;
+        Source src;
+        C c{t};
+        uint8_t rxBuf[128];
+
+        Rig(std::span<const uint8_t> data): src(data)
+        {
+            t.SetPeer(&src);
+            (void)c.Configure().has_value();
+            (void)c.Open().has_value();
+            c.SetDefaultWait(100);
+        }
+        void StartReading() { c.AllowReadUpTo(rxBuf, sizeof(rxBuf)); }
+    };
+
+    struct Result
+    {
+        const char *pName;
+        uint32_t ops = 0;
+        uint32_t failures = 0;
+        uint32_t bytes = 0;
+        uint64_t cycles = 0;
+        uint32_t maxCycles = 0;
+    };
+
+    //times every op separately: total for throughput, max for worst-case latency
+    template<class F>
+    Result Run(const char *pName, uint32_t ops, uint32_t bytesPerOp, F &&op)
+    {
+        Result r{pName};
+        for(uint32_t i = 0; i < ops; ++i)
+        {
+            uint32_t s = k_cycle_get_32();
+            bool ok = op();
+            uint32_t d = k_cycle_get_32() - s;
+            r.cycles += d;
+            r.maxCycles = std::max(r.maxCycles, d);
+            if (!ok)
+                ++r.failures;
+        }
+        r.ops = ops;
+        r.bytes = ops * bytesPerOp;
+        return r;
+    }
+
+    //one JSON object per line
+    void Emit(Result const& r);
+
+    void RunPrimitives(uint32_t ops);
+    void RunDrivers(uint32_t ops);
+    //per-frame gate energy analytics, scalar loops vs lib_ld2412_gates kernels
+    void RunGates(uint32_t ops);
+    //LD2412FlashLog on the flash simulator: cycles per frame, write amplification, erases (CONFIG_FCB only)
+    void RunFlashLog(uint32_t ops);
+    //LD2412 wire encoding: cycles per frame (cyc_per_op) to encode/decode, bytes per frame against the raw structs
+    void RunWire(uint32_t ops);
+    //LD2412 frame latency (avg_ns) per UART rate on the emulator's wire model, frame tail latency
+    //behind a buffered receiver with the rate's RX idle timeout and the old fixed one, and one SetBaudRate
+    void RunBaudrates(uint32_t ops);
+    //LD2412 frames through the zephyr,uart-emul bench_uart with this build's NRF_UART_BACKEND:
+    //frame latency, rx events and poll spins per frame, send cost (native_sim only)
+    void RunBackend(uint32_t ops);
+    //LD2412ChangeFilter over a scripted session: frames against the events it lets through;
+    //distance filters over a noisy scripted walk: cost per reading and mean error against raw
+    void RunFilters(uint32_t ops);
+    //replays a recorded session (capture format) at max speed through a driver
+    void RunCapture(const char *pDriver, std::span<const uint8_t> capture);
+}
+
+#endif
@@ -0,0 +1,84 @@
+#include "bench.h"
+#include "bench_frames.h"
+
+#ifndef NRF_UART_HOST
+#if DT_NODE_EXISTS(DT_NODELABEL(bench_uart))
+#define NRF_UART_BENCH_BACKEND
+#endif
+#endif
+
+#ifdef NRF_UART_BENCH_BACKEND
+#include <nrf_uart/periphery/lib_ld2412.hpp>
+#include <zephyr/drivers/serial/uart_emul.h>
+
+namespace bench
+{
+    namespace
+    {
+        constexpr const char* backend_name(uart::Backend b)
+        {
+            switch(b)
+            {
+                case uart::Backend::Async: return "async";
+                case uart::Backend::Irq: return "irq";
+                case uart::Backend::Poll: return "poll";
+            }
+            return "?";
+        }
+    }
+
+    //native_sim: bench_uart (boards/native_sim.overlay) is a zephyr,uart-emul instance that
+    //supports all three APIs, so the same case runs for each NRF_UART_BACKEND build.
+    //Every op puts one frame into the emulator's RX FIFO and reads it back through the
+    //driver: avg_ns/max_us are the frame latency (put to parsed frame, including the
+    //emulator's work queue hop and, for async, the RX idle timeout); cyc_per_byte is
+    //the CPU cost only where k_cycle_get_32 counts CPU time (on native_sim it is the
+    //simulated clock, so compare rx_events/poll_spins there).
+    void RunBackend(uint32_t ops)
+    {
+        const struct device *pUART = DEVICE_DT_GET(DT_NODELABEL(bench_uart));
+        if (!device_is_ready(pUART))
+        {
+            printk("backend: bench_uart not ready\n");
+            return;
+        }
+        char name[32];
+        const char *pBackend = backend_name(uart::ZephyrUart::kBackend);
+
+        hlk::LD2412 d(pUART);
+        (void)d.Configure().has_value();
+        (void)d.Open().has_value();
+        d.SetDefaultWait(100);
+        d.StartContinuousReading();
+        uart_emul_flush_rx_data(pUART);
+        d.ResetStats();
+        snprintf(name, sizeof(name), "backend_%s_frame", pBackend);
+        Emit(Run(name, ops, sizeof(kLD2412Simple), [&]{
+            if (uart_emul_put_rx_data(pUART, kLD2412Simple, sizeof(kLD2412Simple)) != sizeof(kLD2412Simple))
+                return false;
+            return d.TryReadFrame(1).has_value();
+        }));
+        auto const& s = d.GetStats();
+        //per 100 frames: integer only, like Emit
+        printk("{\"bench\":\"backend_%s_stats\",\"target\":\"%s\",\"ops\":%u,\"rx_bytes\":%u,\"rx_events\":%u"
+                ",\"rx_events_per_100\":%u,\"poll_spins\":%u,\"poll_spins_per_100\":%u,\"overflows\":%u}\n"
+                , pBackend, CONFIG_BOARD, ops, s.rx_bytes, s.rx_events
+                , ops ? s.rx_events * 100 / ops : 0, s.poll_spins, ops ? s.poll_spins * 100 / ops : 0, s.overflows);
+        d.StopContinuousReading();
+
+        //the command path: Send + WaitAllSent of a 14 byte command frame
+        constexpr uint8_t kCmd[] = {0xfd, 0xfc, 0xfb, 0xfa, 0x04, 0x00, 0xff, 0x00, 0x01, 0x00, 0x04, 0x03, 0x02, 0x01};
+        uint8_t echo[sizeof(kCmd)];
+        snprintf(name, sizeof(name), "backend_%s_send", pBackend);
+        Emit(Run(name, ops, sizeof(kCmd), [&]{
+            bool ok = d.Send(kCmd, sizeof(kCmd)).has_value() && d.WaitAllSent().has_value();
+            return uart_emul_get_tx_data(pUART, echo, sizeof(echo)) == sizeof(kCmd) && ok;
+        }));
+    }
+}
+#else
+namespace bench
+{
+    void RunBackend(uint32_t ops) {}
+}
+#endif
@@ -0,0 +1,92 @@
+#include "bench.h"
+#include "bench_frames.h"
+#include <nrf_uart/periphery/lib_ld2412_emu.hpp>
+#include <cstdio>
+
+namespace bench
+{
+    namespace
+    {
+        using LD2412 = hlk::LD2412;
+
+        //header, length, report overhead, payload, footer
+        constexpr uint32_t frame_bytes(LD2412::SystemMode m)
+        {
+            return 4 + 2 + 4 + sizeof(LD2412::PresenceResult) + (m == LD2412::SystemMode::Energy ? sizeof(LD2412::Engeneering) : 0) + 4;
+        }
+
+        //frame tail latency of a buffered (DMA) receiver: a frame arrives at once, the whole
+        //kRxBounceSize pieces go to the driver right away, the rest after idleUS of silence.
+        //avg_ns is the time from the frame's last byte to the parsed frame.
+        void RunTail(const char *pName, uint32_t ops, std::span<const uint8_t> frame, int32_t idleUS)
+        {
+            uart::MemoryTransportStatic<512> t;
+            t.SetRxBuffering(uart::kRxBounceSize, idleUS);
+            LD2412 d(t);
+            (void)d.Configure().has_value();
+            (void)d.Open().has_value();
+            d.SetDefaultWait(LD2412::kDefaultWait);
+            d.StartContinuousReading();
+            Emit(Run(pName, ops, frame.size(), [&]{
+                if (t.Feed(frame.data(), frame.size()) != frame.size())
+                    return false;
+                return d.TryReadFrame(1).has_value();
+            }));
+        }
+    }
+
+    void RunBaudrates(uint32_t ops)
+    {
+        constexpr LD2412::BaudRate kRates[] = {LD2412::BaudRate::_115200, LD2412::BaudRate::_256000, LD2412::BaudRate::_460800};
+        const uint32_t frames = std::min<uint32_t>(ops, 200);
+        for(LD2412::BaudRate rate : kRates)
+        {
+            const uint32_t baud = LD2412::to_baudrate(rate);
+            //time on the wire (10 bits per byte) = time RX is busy per frame; the measured
+            //cases below can't go under 1ms: the emulator streams at most a frame per ms
+            printk("{\"bench\":\"ld2412_wire_%u\",\"simple_bytes\":%u,\"simple_us\":%u,\"energy_bytes\":%u,\"energy_us\":%u}\n"
+                    , baud, frame_bytes(LD2412::SystemMode::Simple), frame_bytes(LD2412::SystemMode::Simple) * 10'000'000u / baud
+                    , frame_bytes(LD2412::SystemMode::Energy), frame_bytes(LD2412::SystemMode::Energy) * 10'000'000u / baud);
+            char name[40];
+            //with the RX idle timeout ZephyrUart uses at this rate
+            snprintf(name, sizeof(name), "ld2412_tail_%u_simple", baud);
+            RunTail(name, frames, kLD2412Simple, uart::rx_idle_timeout_us(baud));
+            snprintf(name, sizeof(name), "ld2412_tail_%u_energy", baud);
+            RunTail(name, frames, kLD2412Energy.data, uart::rx_idle_timeout_us(baud));
+            for(LD2412::SystemMode mode : {LD2412::SystemMode::Simple, LD2412::SystemMode::Energy})
+            {
+                uart::MemoryTransportStatic<512> t(baud);
+                hlk::LD2412Emu emu;
+                emu.Attach(t);
+                emu.SetWireModel(true);
+                LD2412 d(t);
+                if (d.Init() && d.SwitchSystemMode(mode))
+                {
+                    //a frame per ms keeps the wire busy where a frame takes longer: latency = wire time + parsing
+                    emu.SetDataRate(1000);
+                    d.StartContinuousReading();
+                    (void)d.TryReadFrame(3).has_value();
+                    snprintf(name, sizeof(name), "ld2412_frame_%u_%s", baud, mode == LD2412::SystemMode::Energy ? "energy" : "simple");
+                    Emit(Run(name, frames, frame_bytes(mode), [&]{ return d.TryReadFrame(1).has_value(); }));
+                }else
+                    printk("ld2412_frame_%u: init failed\n", baud);
+            }
+        }
+
+        //before the timeout followed the rate: the read wait (350ms for LD2412) at any rate; slow, so few frames
+        const uint32_t waitFrames = std::min<uint32_t>(ops, 10);
+        RunTail("ld2412_tail_wait_simple", waitFrames, kLD2412Simple, int32_t(LD2412::kDefaultWait) * 1000);
+        RunTail("ld2412_tail_wait_energy", waitFrames, kLD2412Energy.data, int32_t(LD2412::kDefaultWait) * 1000);
+
+        //the negotiation itself: SetBaudRate, module restart, version check
+        uart::MemoryTransportStatic<512> t(LD2412::kDefaultBaudrate);
+        hlk::LD2412Emu emu;
+        emu.Attach(t);
+        emu.SetRestartTime(200);
+        emu.SetDataRate(10);
+        LD2412 d(t);
+        if (!d.Init())
+            return;
+        Emit(Run("ld2412_set_baud_460800", 1, 0, [&]{ return d.SetBaudRate(LD2412::BaudRate::_460800).has_value(); }));
+    }
+}
@@ -0,0 +1,139 @@
+#include "bench.h"
+#include "bench_frames.h"
+#include <nrf_uart/periphery/lib_ld2412.hpp>
+#include <nrf_uart/periphery/lib_dfr_c4001.h>
+#include <nrf_uart/lib_capture_replay.h>
+#include <cstring>
+
+namespace bench
+{
+    namespace
+    {
+        template<size_t N>
+        constexpr std::span<const uint8_t> bytes_of(const char (&s)[N]) { return {(const uint8_t*)s, N - 1}; }
+
+        constexpr char kC4001Target[] = "$DFDMD,1,0,3.250,-0.500,1234.000, , *\r\n";
+        constexpr char kC4001PresenceNoisy[] = "Done\r\nleapMMW:/>\r\n$DFHPD,1, , , *\r\n";
+    }
+
+    void RunDrivers(uint32_t ops)
+    {
+        {
+            Rig<hlk::LD2412> rig(kLD2412Simple);
+            rig.c.StartContinuousReading();
+            Emit(Run("ld2412_simple_recorded", ops, sizeof(kLD2412Simple), [&]{
+                return rig.c.TryReadFrame(1).has_value();
+            }));
+        }
+        {
+            Rig<hlk::LD2412> rig(kLD2412SimpleNoisy);
+            rig.c.StartContinuousReading();
+            //two false headers in the noise: the default 3 attempts resync on every record
+            Emit(Run("ld2412_simple_noisy", ops, sizeof(kLD2412SimpleNoisy), [&]{
+                return rig.c.TryReadFrame(3).has_value();
+            }));
+        }
+        {
+            Rig<hlk::LD2412> rig(kLD2412Energy.data);
+            rig.c.StartContinuousReading();
+            Emit(Run("ld2412_energy_synthetic", ops, sizeof(kLD2412Energy.data), [&]{
+                return rig.c.TryReadFrame(1).has_value();
+            }));
+        }
+        {
+            Rig<dfr::C4001> rig(bytes_of(kC4001Target));
+            rig.c.StartContinuousReading();
+            Emit(Run("c4001_target", ops, sizeof(kC4001Target) - 1, [&]{
+                return rig.c.TryReadFrame(1).has_value();
+            }));
+        }
+        {
+            Rig<dfr::C4001> rig(bytes_of(kC4001PresenceNoisy));
+            rig.c.StartContinuousReading();
+            Emit(Run("c4001_presence_noisy", ops, sizeof(kC4001PresenceNoisy) - 1, [&]{
+                return rig.c.TryReadFrame(1).has_value();
+            }));
+        }
+    }
+
+    namespace
+    {
+        //no rx progress for this long ends a replay even if it isn't Done (a stalled replay
+        //skips its sync point after Replay::kStallUs, this is the backstop)
+        constexpr int64_t kReplayIdleMs = 2000;
+
+        template<class C>
+        Result ReplayThrough(const char *pName, std::span<const uint8_t> capture)
+        {
+            uart::MemoryTransportStatic<512> t;
+            uart::capture::Replay replay(capture, uart::capture::Replay::Speed::Max);
+            t.SetPeer(&replay);
+            C c{t};
+            Result r{pName};
+            //commands in the capture get their recorded answers; not timed
+            if (!c.Init())
+                ++r.failures;
+            c.StartContinuousReading();
+            //64 bit: on the host 1 cycle = 1ns, 32 bits wrap after 4.3s
+            uint64_t start = k_cycle_get_64();
+            uint32_t rxBefore = c.GetStats().rx_bytes;
+            uint32_t rxSeen = rxBefore;
+            int64_t rxSeenMs = k_uptime_get();
+            //the replay as of the last rx progress: an idle end doesn't count the backstop wait
+            uint64_t rxSeenCycles = start;
+            uint32_t rxSeenOps = 0, rxSeenFailures = r.failures;
+            bool idle = false;
+            for(;;)
+            {
+                uint32_t s = k_cycle_get_32();
+                bool ok = c.TryReadFrame(1).has_value();
+                if (!ok && replay.Done() && !t.Pending())
+                    break;//end of capture
+                bool progress = false;
+                if (uint32_t rx = c.GetStats().rx_bytes; rx != rxSeen)
+                {
+                    rxSeen = rx;
+                    rxSeenMs = k_uptime_get();
+                    progress = true;
+                }else if (k_uptime_get() - rxSeenMs > kReplayIdleMs)
+                {
+                    idle = true;
+                    break;
+                }
+                r.maxCycles = std::max(r.maxCycles, k_cycle_get_32() - s);
+                ++r.ops;
+                if (!ok)
+                    ++r.failures;
+                if (progress)
+                {
+                    rxSeenCycles = k_cycle_get_64();
+                    rxSeenOps = r.ops;
+                    rxSeenFailures = r.failures;
+                }
+            }
+            if (idle)
+            {
+                r.ops = rxSeenOps;
+                r.failures = rxSeenFailures;
+                r.cycles = rxSeenCycles - start;
+            }else
+                r.cycles = k_cycle_get_64() - start;
+            r.bytes = c.GetStats().rx_bytes - rxBefore;
+            auto const& rs = replay.GetStats();
+            printk("{\"bench\":\"%s_replay\",\"rx_bytes\":%u,\"tx_bytes\":%u,\"tx_mismatch\":%u"
+                    ",\"stalls\":%u,\"tx_skipped\":%u,\"end\":\"%s\"}\n"
+                    , pName, rs.rxBytes, rs.txBytes, rs.txMismatch, rs.stalls, rs.txSkipped, idle ? "idle" : "eos");
+            return r;
+        }
+    }
+
+    void RunCapture(const char *pDriver, std::span<const uint8_t> capture)
+    {
+        if (std::string_view(pDriver) == "ld2412")
+            Emit(ReplayThrough<hlk::LD2412>("capture_ld2412", capture));
+        else if (std::string_view(pDriver) == "c4001")
+            Emit(ReplayThrough<dfr::C4001>("capture_c4001", capture));
+        else
+            printk("unknown driver %s\n", pDriver);
+    }
+}
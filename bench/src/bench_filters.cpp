@@ -0,0 +1,172 @@
+#include "bench.h"
+#include <nrf_uart/periphery/lib_ld2412_change.hpp>
+#include <nrf_uart/lib_track_filters.h>
+#include <cstdlib>
+
+namespace bench
+{
+    namespace
+    {
+        using LD2412 = hlk::LD2412;
+
+        //80s at 12.5 frames/s: 16s empty, a person walks in (with one flap of
+        //the state on arrival), stands still for 48s, leaves. Readings jitter
+        //within the default hysteresis (30cm, 20 energy) while standing.
+        struct Session
+        {
+            static constexpr const uint32_t kFrameMs = 80;
+            static constexpr const uint32_t kPeriod = 1000;
+
+            LD2412::PresenceResult p{};
+            uint32_t x = 0x2412;
+
+            uint32_t noise(uint32_t range)
+            {
+                x = x * 1103515245 + 12345;
+                return (x >> 16) % range;
+            }
+
+            void Next(uint32_t frame)
+            {
+                const uint32_t phase = frame % kPeriod;
+                p = {};
+                if (phase < 200 || phase >= 900 || phase == 201)
+                    return;//empty; 201 - the flap right after arrival
+                if (phase < 300)
+                {
+                    //walking in from 700cm to 400cm
+                    p.m_State = LD2412::TargetState::Move;
+                    p.m_MoveDistance = uint16_t(700 - (phase - 200) * 3 + noise(10));
+                    p.m_MoveEnergy = uint8_t(60 + noise(10));
+                    return;
+                }
+                p.m_State = LD2412::TargetState::Still;
+                p.m_StillDistance = uint16_t(395 + noise(20));
+                p.m_StillEnergy = uint8_t(40 + noise(10));
+            }
+        };
+
+        //32s at 12.5 readings/s: walking away at 50cm/s from 200cm for 16s,
+        //then standing at 1000cm. Readings carry ~15cm of noise (sum of three
+        //uniform +-15cm) and are quantised to 20cm gates; the first reading of
+        //a walk is missing, so every walk restarts the track.
+        struct Walk
+        {
+            static constexpr const uint32_t kFrameMs = 80;
+            static constexpr const uint32_t kPeriod = 400;
+            //readings after a restart not scored: the filters are still settling
+            static constexpr const uint32_t kSettle = 50;
+
+            uint32_t x = 0x2412;
+            int32_t truth = 0;//cm
+            int32_t truthV = 0;//cm/s
+            int32_t z = 0;
+            bool present = false;
+            bool scored = false;
+
+            int32_t noise()
+            {
+                int32_t n = 0;
+                for(int i = 0; i < 3; ++i)
+                {
+                    x = x * 1103515245 + 12345;
+                    n += int32_t((x >> 16) % 31) - 15;
+                }
+                return n;
+            }
+
+            void Next(uint32_t frame)
+            {
+                const uint32_t phase = frame % kPeriod;
+                const int32_t tMs = int32_t(phase * kFrameMs);
+                truthV = tMs < 16000 ? 50 : 0;
+                truth = 200 + std::min(tMs, 16000) * 50 / 1000;
+                present = phase != 0;
+                scored = phase > kSettle;
+                const int32_t r = truth + noise();
+                z = (r + 10) / 20 * 20;
+            }
+        };
+
+        struct TrackError
+        {
+            uint64_t sum = 0;
+            uint64_t sumV = 0;
+            uint32_t n = 0;
+
+            void Add(Walk const& w, int32_t d, int32_t v)
+            {
+                if (!w.scored)
+                    return;
+                sum += uint32_t(std::abs(d - w.truth));
+                sumV += uint32_t(std::abs(v - w.truthV));
+                ++n;
+            }
+
+            //mean absolute errors in 1/100 cm and 1/100 cm/s
+            void Print(const char *pName) const
+            {
+                uint32_t e100 = n ? uint32_t(sum * 100 / n) : 0;
+                uint32_t v100 = n ? uint32_t(sumV * 100 / n) : 0;
+                printk("{\"bench\":\"%s_error\",\"scored\":%u,\"mean_err_cm\":%u.%02u,\"mean_verr_cm_s\":%u.%02u}\n"
+                        , pName, n, e100 / 100, e100 % 100, v100 / 100, v100 % 100);
+            }
+        };
+
+        template<class F>
+        void RunTrack(const char *pName, uint32_t ops)
+        {
+            uart::filters::Track<F> tr;
+            Walk w;
+            TrackError err;
+            uint32_t frame = 0;
+            Emit(Run(pName, ops, 0, [&]{
+                w.Next(frame);
+                tr.Add(w.present, w.z, int64_t(frame) * Walk::kFrameMs);
+                ++frame;
+                if (tr.Valid())
+                    err.Add(w, tr.Get().distance, tr.Get().velocity);
+                return true;
+            }));
+            err.Print(pName);
+        }
+    }
+
+    void RunFilters(uint32_t ops)
+    {
+        {
+            hlk::LD2412ChangeFilter f;
+            hlk::LD2412ChangeFilter::Event ev;
+            Session s;
+            uint32_t frame = 0;
+            Emit(Run("ld2412_change_filter", ops, 0, [&]{
+                s.Next(frame);
+                (void)f.Add(s.p, int64_t(frame) * Session::kFrameMs, ev);
+                ++frame;
+                return true;
+            }));
+            auto const& st = f.GetStats();
+            //frames per event, integer only like Emit
+            uint32_t ratio100 = st.events ? st.frames * 100 / st.events : 0;
+            printk("{\"bench\":\"ld2412_change_events\",\"sim_s\":%u,\"frames\":%u,\"events\":%u,\"suppressed\":%u,\"frames_per_event\":%u.%02u}\n"
+                    , frame * Session::kFrameMs / 1000, st.frames, st.events, st.suppressedTransitions, ratio100 / 100, ratio100 % 100);
+        }
+        {
+            //the readings as they are, velocity from two consecutive ones: the
+            //baseline the filters are scored against
+            Walk w;
+            TrackError err;
+            int32_t prev = 0;
+            for(uint32_t frame = 0; frame < ops; ++frame)
+            {
+                w.Next(frame);
+                err.Add(w, w.z, (w.z - prev) * 1000 / int32_t(Walk::kFrameMs));
+                prev = w.z;
+            }
+            err.Print("track_raw");
+        }
+        RunTrack<uart::filters::Ema<3>>("track_ema", ops);
+        RunTrack<uart::filters::AlphaBeta<64, 8>>("track_alpha_beta", ops);
+        RunTrack<uart::filters::Kalman<50, 15>>("track_kalman", ops);
+    }
+}
@@ -0,0 +1,101 @@
+#include "bench.h"
+
+#if defined(CONFIG_FCB)
+#include <nrf_uart/periphery/lib_ld2412_flash_log.hpp>
+
+namespace bench
+{
+    namespace
+    {
+        //a frame every 100ms of simulated time; mostly quiet with a burst of
+        //flapping transitions every 30s, and a snapshot whenever allowed
+        struct Session
+        {
+            static constexpr const uint32_t kFrameMs = 100;
+
+            hlk::LD2412::PresenceResult p{};
+            hlk::LD2412::Engeneering e{};
+            int64_t now = 0;
+            uint32_t frame = 0;
+
+            bool Step(hlk::LD2412FlashLog &log)
+            {
+                now += kFrameMs;
+                ++frame;
+                bool burst = (frame % 300) < 40;
+                if (burst || (frame % 50) == 0)
+                {
+                    p.m_State = p.m_State == hlk::LD2412::TargetState::Clear ? hlk::LD2412::TargetState::Move : hlk::LD2412::TargetState::Clear;
+                    p.m_MoveDistance = uint16_t(frame % 600);
+                    (void)log.AddTransition(p, now);
+                }
+                e.m_MoveEnergy[frame % hlk::LD2412::kGateCount] = uint8_t(frame);
+                (void)log.AddEngineering(e, now);
+                return log.Poll(now) == 0;
+            }
+        };
+
+        //wear run: until the partition wrapped kWraps times, at most kMaxSimS of simulated time
+        constexpr uint32_t kWraps = 2;
+        constexpr uint32_t kMaxSimS = 30 * 24 * 3600;
+    }
+
+    //native_sim: the flash simulator's storage_partition stands in for the device's
+    void RunFlashLog(uint32_t ops)
+    {
+        static uint8_t batch[512];
+        static flash_sector sectors[64];
+        hlk::LD2412FlashLog log(batch, sectors);
+        hlk::LD2412FlashLog::Config cfg;
+        cfg.flushMs = 60000;
+        cfg.ratePerMinute = 120;
+        cfg.burst = 20;
+        cfg.minSnapshotMs = 10000;
+        if (log.Init(FIXED_PARTITION_ID(storage_partition), cfg) != 0 || log.Clear() != 0)
+        {
+            printk("flash_log: storage_partition unusable\n");
+            return;
+        }
+
+        {
+            Session s;
+            Result r = Run("flash_log_frame", ops, 0, [&]{ return s.Step(log); });
+            (void)log.Flush();
+            r.bytes = log.GetStats().payloadBytes;
+            Emit(r);
+        }
+
+        //wear: the same session, long enough to wrap the partition. Clear erases every sector once,
+        //then FCB erases the oldest sector per rotation, round robin, so no sector is erased more than
+        //1 + ceil(rotations / sectors) times. Write amplification = flash bytes / record bytes.
+        if (log.Clear() != 0)
+            return;
+        log.ResetStats();
+        Session s;
+        const uint32_t n = log.GetSectorCount();
+        uint32_t failures = 0;
+        while(log.GetStats().rotations < kWraps * n && s.now < int64_t(kMaxSimS) * 1000)
+            failures += !s.Step(log);
+        (void)log.Flush();
+        auto const& st = log.GetStats();
+        const uint32_t erases = n + st.rotations;
+        const uint32_t perSector100 = n ? erases * 100 / n : 0;
+        const uint32_t maxPerSector = n ? 1 + (st.rotations + n - 1) / n : 0;
+        const uint32_t simS = uint32_t(s.now / 1000);
+        //erases per sector per year at this rate; the partition's endurance budget is the device's
+        const uint32_t perYear = simS && n ? uint32_t(uint64_t(st.rotations) * 365 * 24 * 3600 / simS / n) : 0;
+        uint32_t wa100 = st.payloadBytes ? uint32_t(uint64_t(st.flashBytes) * 100 / st.payloadBytes) : 0;
+        printk("{\"bench\":\"flash_log_wear\",\"target\":\"%s\",\"sim_s\":%u,\"frames\":%u,\"records\":%u,\"dropped\":%u,\"batches\":%u"
+                ",\"payload\":%u,\"flash_bytes\":%u,\"write_amp\":%u.%02u,\"sectors\":%u,\"rotations\":%u,\"erases\":%u"
+                ",\"erases_per_sector\":%u.%02u,\"max_erases_per_sector\":%u,\"erases_per_sector_year\":%u,\"errors\":%u,\"fail\":%u}\n"
+                , CONFIG_BOARD, simS, s.frame, st.records, st.dropped, st.batches
+                , st.payloadBytes, st.flashBytes, wa100 / 100, wa100 % 100, n, st.rotations, erases
+                , perSector100 / 100, perSector100 % 100, maxPerSector, perYear, st.errors, failures);
+    }
+}
+#else
+namespace bench
+{
+    void RunFlashLog(uint32_t ops) {}
+}
+#endif
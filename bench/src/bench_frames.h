@@ -0,0 +1,43 @@
+#ifndef NRF_UART_BENCH_FRAMES_H_
+#define NRF_UART_BENCH_FRAMES_H_
+
+#include <cstdint>
+#include <cstddef>
+
+namespace bench
+{
+    //recorded from a module: Simple mode, still target at 160cm, energy 100
+    inline constexpr uint8_t kLD2412Simple[] = {
+        0xf4, 0xf3, 0xf2, 0xf1, 0x0b, 0x00, 0x02, 0xaa, 0x02, 0x00, 0x00, 0x00, 0xa0, 0x00, 0x64, 0x55, 0x00, 0xf8, 0xf7, 0xf6, 0xf5
+    };
+
+    //the recorded frame after line noise the reader has to skip
+    inline constexpr uint8_t kLD2412SimpleNoisy[] = {
+        0x00, 0xf4, 0x13, 0xf4, 0xf3, 0x55, 0xaa, 0xff,
+        0xf4, 0xf3, 0xf2, 0xf1, 0x0b, 0x00, 0x02, 0xaa, 0x02, 0x00, 0x00, 0x00, 0xa0, 0x00, 0x64, 0x55, 0x00, 0xf8, 0xf7, 0xf6, 0xf5
+    };
+
+    //synthetic Energy mode frame: header, len, mode, 0xaa, presence(7), engineering(32), 0x55, check, footer
+    struct EnergyFrame
+    {
+        uint8_t data[4 + 2 + 43 + 4];
+
+        constexpr EnergyFrame(): data{}
+        {
+            constexpr uint8_t head[] = {0xf4, 0xf3, 0xf2, 0xf1, 43, 0x00, 0x01, 0xaa, 0x03, 0x78, 0x00, 0x3c, 0xa0, 0x00, 0x28};
+            constexpr uint8_t tail[] = {0x55, 0x00, 0xf8, 0xf7, 0xf6, 0xf5};
+            size_t i = 0;
+            for(uint8_t b : head) data[i++] = b;
+            data[i++] = 3;//max move gate
+            data[i++] = 2;//max still gate
+            for(int g = 0; g < 14; ++g) data[i++] = uint8_t(10 + g * 5);
+            for(int g = 0; g < 14; ++g) data[i++] = uint8_t(80 - g * 5);
+            data[i++] = 120;//light
+            data[i++] = 0;
+            for(uint8_t b : tail) data[i++] = b;
+        }
+    };
+    inline constexpr EnergyFrame kLD2412Energy{};
+}
+
+#endif
@@ -0,0 +1,109 @@
+#include "bench.h"
+#include <nrf_uart/periphery/lib_ld2412_gates.hpp>
+
+namespace bench
+{
+    namespace
+    {
+        using gate_array_t = hlk::LD2412::gate_array_t;
+
+        //a frame sequence with some movement in it; indexed by op so the data isn't constant
+        struct Frames
+        {
+            gate_array_t energy[16];
+            gate_array_t threshold;
+
+            Frames()
+            {
+                uint32_t x = 0x2412;
+                for(auto &f : energy)
+                    for(auto &e : f)
+                    {
+                        x = x * 1103515245 + 12345;
+                        e = uint8_t((x >> 16) % 101);
+                    }
+                for(size_t g = 0; g < threshold.size(); ++g)
+                    threshold[g] = uint8_t(50 - g * 2);
+            }
+            gate_array_t const& operator[](uint32_t i) const { return energy[i % 16]; }
+        };
+
+        //what the kernels replace: one pass of plain loops per frame
+        struct Scalar
+        {
+            static uint16_t above(gate_array_t const& e, gate_array_t const& t)
+            {
+                uint16_t m = 0;
+                for(size_t g = 0; g < e.size(); ++g)
+                    if (e[g] > t[g])
+                        m |= 1 << g;
+                return m;
+            }
+            static gate_array_t abs_diff(gate_array_t const& a, gate_array_t const& b)
+            {
+                gate_array_t r;
+                for(size_t g = 0; g < a.size(); ++g)
+                    r[g] = a[g] > b[g] ? a[g] - b[g] : b[g] - a[g];
+                return r;
+            }
+            static hlk::gates::MaxGate max_gate(gate_array_t const& a)
+            {
+                hlk::gates::MaxGate m{a[0], 0};
+                for(size_t g = 1; g < a.size(); ++g)
+                    if (a[g] > m.value)
+                        m = {a[g], uint8_t(g)};
+                return m;
+            }
+            static uint16_t sum(gate_array_t const& a)
+            {
+                uint16_t s = 0;
+                for(uint8_t e : a)
+                    s += e;
+                return s;
+            }
+        };
+
+        //the per-frame analytics a consumer would run: detection mask, motion vs previous frame, peak gate
+        template<class K>
+        uint32_t analyse(Frames const& f, uint32_t i)
+        {
+            auto const& cur = f[i];
+            uint16_t mask = K::above(cur, f.threshold);
+            uint16_t motion = K::sum(K::abs_diff(cur, f[i + 15]));
+            auto peak = K::max_gate(cur);
+            return mask ^ motion ^ (peak.gate << 8) ^ peak.value;
+        }
+
+        struct Kernels
+        {
+            static uint16_t above(gate_array_t const& e, gate_array_t const& t) { return hlk::gates::above(e, t); }
+            static gate_array_t abs_diff(gate_array_t const& a, gate_array_t const& b) { return hlk::gates::abs_diff(a, b); }
+            static hlk::gates::MaxGate max_gate(gate_array_t const& a) { return hlk::gates::max_gate(a); }
+            static uint16_t sum(gate_array_t const& a) { return hlk::gates::sum(a); }
+        };
+    }
+
+    void RunGates(uint32_t ops)
+    {
+        static const Frames f;
+        volatile uint32_t sink = 0;
+        uint32_t i = 0;
+        //bytes: both energy arrays of a frame
+        Emit(Run("gates_frame_scalar", ops, 2 * hlk::LD2412::kGateCount, [&]{
+            sink = sink + analyse<Scalar>(f, i++);
+            return true;
+        }));
+        i = 0;
+        Emit(Run(NRF_UART_GATES_DSP ? "gates_frame_dsp" : "gates_frame_swar", ops, 2 * hlk::LD2412::kGateCount, [&]{
+            sink = sink + analyse<Kernels>(f, i++);
+            return true;
+        }));
+        //results must agree, a mismatch shows up as failures
+        i = 0;
+        Emit(Run("gates_frame_check", 16, 0, [&]{
+            bool same = analyse<Scalar>(f, i) == analyse<Kernels>(f, i);
+            ++i;
+            return same;
+        }));
+    }
+}
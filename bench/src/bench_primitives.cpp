@@ -0,0 +1,79 @@
+#include "bench.h"
+#include <nrf_uart/lib_uart_primitives.h>
+#include <nrf_uart/periphery/lib_dfr_c4001.h>
+#include <array>
+
+namespace bench
+{
+    namespace uartp = uart::primitives;
+
+    namespace
+    {
+        template<size_t N>
+        constexpr std::span<const uint8_t> bytes_of(const char (&s)[N]) { return {(const uint8_t*)s, N - 1}; }
+
+        constexpr uint8_t kLD2412Header[] = {0xFD, 0xFC, 0xFB, 0xFA};
+
+        //LD2412 GetMoveSensitivity ACK payload: cmd|0x100, status, 14 gates
+        constexpr uint8_t kGatesAck[] = {
+            0x13, 0x01, 0x00, 0x00,
+            0x32, 0x32, 0x28, 0x1e, 0x14, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f,
+        };
+
+        //C4001 shell output around a getRange
+        constexpr char kShell[] = "$DFHPD,0, , , *\r\ngetRange\r\nResponse 0.600 25.000\r\nDone\r\n";
+        constexpr char kResponse[] = "Response 0.600 25.000\r\n";
+        constexpr char kFloat[] = "12.345 ";
+    }
+
+    void RunPrimitives(uint32_t ops)
+    {
+        {
+            Rig<> rig(kLD2412Header);
+            rig.StartReading();
+            Emit(Run("match_bytes", ops, sizeof(kLD2412Header), [&]{
+                return uartp::match_bytes(rig.c, kLD2412Header).has_value();
+            }));
+        }
+        {
+            Rig<> rig(bytes_of(kShell));
+            rig.StartReading();
+            Emit(Run("find_bytes", ops, sizeof(kShell) - 1, [&]{
+                return uartp::find_bytes(rig.c, "Done\r\n").has_value();
+            }));
+        }
+        {
+            Rig<> rig(bytes_of(kShell));
+            rig.StartReading();
+            Emit(Run("find_any_str", ops, sizeof(kShell) - 1, [&]{
+                return uartp::find_any_str({}, rig.c, "Done\r\n", "Error\r\n").has_value();
+            }));
+        }
+        {
+            Rig<> rig(bytes_of(kResponse));
+            rig.StartReading();
+            uint8_t dst[32];
+            Emit(Run("read_until_into", ops, sizeof(kResponse) - 1, [&]{
+                return uartp::read_until_into(rig.c, '\n', dst, sizeof(dst), true, {}).has_value();
+            }));
+        }
+        {
+            Rig<> rig(kGatesAck);
+            rig.StartReading();
+            uint16_t status;
+            std::array<uint8_t, 14> gates;
+            Emit(Run("read_any_limited", ops, sizeof(kGatesAck), [&]{
+                uint16_t limit = sizeof(kGatesAck);
+                return uartp::read_any_limited(rig.c, limit, uartp::match_t{uint16_t(0x0113)}, status, gates).has_value();
+            }));
+        }
+        {
+            Rig<> rig(bytes_of(kFloat));
+            rig.StartReading();
+            float v;
+            Emit(Run("read_float_from_str", ops, sizeof(kFloat) - 1, [&]{
+                return uartp::read_any(rig.c, dfr::read_float_from_str_t{v, ' '}).has_value();
+            }));
+        }
+    }
+}
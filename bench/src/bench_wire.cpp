@@ -0,0 +1,123 @@
+#include "bench.h"
+#include <nrf_uart/periphery/lib_ld2412_wire.hpp>
+#include <cstring>
+
+namespace bench
+{
+    namespace
+    {
+        using LD2412 = hlk::LD2412;
+
+        //a person walking in and standing still: distances drift, most gates jitter
+        //by a few units, the gates around the target swing more
+        struct Scene
+        {
+            LD2412::PresenceResult p{};
+            LD2412::Engeneering e{};
+            uint32_t x = 0x2412;
+
+            uint8_t noise(uint8_t range)
+            {
+                x = x * 1103515245 + 12345;
+                return uint8_t((x >> 16) % range);
+            }
+
+            void Next(uint32_t frame)
+            {
+                const uint32_t phase = frame % 400;
+                const bool present = phase >= 50;
+                const uint16_t dist = uint16_t(present ? 600 - std::min<uint32_t>(phase - 50, 150) * 3 : 0);
+                p.m_State = !present ? LD2412::TargetState::Clear : phase < 200 ? LD2412::TargetState::Move : LD2412::TargetState::Still;
+                p.m_MoveDistance = p.m_State == LD2412::TargetState::Move ? uint16_t(dist + noise(5)) : 0;
+                p.m_StillDistance = present ? uint16_t(dist + noise(3)) : 0;
+                p.m_MoveEnergy = p.m_State == LD2412::TargetState::Move ? uint8_t(60 + noise(20)) : 0;
+                p.m_StillEnergy = present ? uint8_t(40 + noise(10)) : 0;
+                e.m_MaxMoveGate = LD2412::kMaxGate;
+                e.m_MaxStillGate = LD2412::kMaxGate;
+                e.m_Light = uint8_t(80 + noise(2));
+                const uint8_t targetGate = uint8_t(dist / 75);
+                for(uint8_t g = 0; g < LD2412::kGateCount; ++g)
+                {
+                    const bool near = present && (g == targetGate || g + 1 == targetGate || g == targetGate + 1);
+                    e.m_MoveEnergy[g] = uint8_t(near && p.m_State == LD2412::TargetState::Move ? 50 + noise(40) : 5 + noise(4));
+                    e.m_StillEnergy[g] = uint8_t(near ? 30 + noise(8) : 3 + noise(3));
+                }
+            }
+        };
+
+        //everything the wire format carries (PresenceResult is packed: all of it)
+        bool same(LD2412::PresenceResult const& a, LD2412::PresenceResult const& b)
+        {
+            return std::memcmp(&a, &b, sizeof(a)) == 0;
+        }
+
+        bool same(LD2412::Engeneering const& a, LD2412::Engeneering const& b)
+        {
+            return a.m_MaxMoveGate == b.m_MaxMoveGate && a.m_MaxStillGate == b.m_MaxStillGate
+                && a.m_MoveEnergy == b.m_MoveEnergy && a.m_StillEnergy == b.m_StillEnergy
+                && a.m_Light == b.m_Light;
+        }
+    }
+
+    void RunWire(uint32_t ops)
+    {
+        static constexpr const uint32_t kFrames = 1024;
+        static constexpr const size_t kRaw = sizeof(LD2412::PresenceResult) + sizeof(LD2412::Engeneering);
+        //encoded once up front so the encode case times only the encoder
+        static LD2412::PresenceResult presence[kFrames];
+        static LD2412::Engeneering eng[kFrames];
+        static uint8_t stream[kFrames * hlk::wire::kMaxFrame];
+        static uint16_t offsets[kFrames + 1];
+        Scene scene;
+        for(uint32_t i = 0; i < kFrames; ++i)
+        {
+            scene.Next(i);
+            presence[i] = scene.p;
+            eng[i] = scene.e;
+        }
+
+        for(bool energy : {false, true})
+        {
+            hlk::wire::Encoder enc;
+            uint32_t i = 0, total = 0;
+            Result r = Run(energy ? "wire_encode_energy" : "wire_encode_simple", ops, 0, [&]{
+                uint8_t buf[hlk::wire::kMaxFrame];
+                size_t n = enc.Encode(buf, presence[i % kFrames], energy ? &eng[i % kFrames] : nullptr);
+                ++i;
+                total += n;
+                return n != 0;
+            });
+            r.bytes = total;
+            Emit(r);
+
+            //a stream of kFrames to decode: the encoder's own keyframe interval
+            hlk::wire::Encoder streamEnc;
+            size_t used = 0;
+            for(uint32_t f = 0; f < kFrames; ++f)
+            {
+                offsets[f] = uint16_t(used);
+                used += streamEnc.Encode(std::span(stream + used, sizeof(stream) - used), presence[f], energy ? &eng[f] : nullptr);
+            }
+            offsets[kFrames] = uint16_t(used);
+
+            hlk::wire::Decoder dec;
+            i = 0;
+            r = Run(energy ? "wire_decode_energy" : "wire_decode_simple", ops, 0, [&]{
+                const uint32_t f = i++ % kFrames;
+                if (!f)
+                    dec.Reset();//the stream starts over: its first frame is a keyframe
+                auto res = dec.Decode(std::span<const uint8_t>(stream + offsets[f], offsets[f + 1] - offsets[f]));
+                return res && same(res->presence, presence[f]) && (!energy || same(res->engineering, eng[f]));
+            });
+            r.bytes = uint32_t(uint64_t(used) * ops / kFrames);
+            Emit(r);
+
+            //bytes per frame against the raw structs, x100
+            const size_t raw = energy ? kRaw : sizeof(LD2412::PresenceResult);
+            printk("{\"bench\":\"wire_size_%s\",\"frames\":%u,\"bytes\":%u,\"bytes_per_frame\":%u.%02u,\"raw_per_frame\":%u,\"ratio_pct\":%u}\n"
+                    , energy ? "energy" : "simple", kFrames, uint32_t(used)
+                    , uint32_t(used * 100 / kFrames) / 100, uint32_t(used * 100 / kFrames) % 100
+                    , uint32_t(raw), uint32_t(used * 100 / (raw * kFrames)));
+        }
+    }
+}
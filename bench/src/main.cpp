@@ -0,0 +1,43 @@
+#include "bench.h"
+#include <cstdlib>
+#ifdef NRF_UART_HOST
+#include <nrf_uart/host/lib_capture_file.h>
+#endif
+
+//Results are printed as one JSON object per line, e.g.
+//{"bench":"match_bytes","target":"host","ops":2000,"fail":0,"bytes":8000,"cyc_per_byte":41.20,...}
+//cyc_per_byte/cyc_per_op/avg_ns/ops_per_s are throughput figures, max_us is the worst
+//single op and is the figure to watch for latency regressions.
+static constexpr const uint32_t kDefaultOps = 2000;
+
+#ifdef NRF_UART_HOST
+//nrf_uart_bench [ops] [ld2412|c4001 <capture file>]
+int main(int argc, char **argv)
+{
+    uint32_t ops = argc > 1 ? uint32_t(strtoul(argv[1], nullptr, 10)) : kDefaultOps;
+    if (argc > 3)
+    {
+        std::vector<uint8_t> capture;
+        if (int r = uart::capture::load_file(argv[3], capture); r != 0)
+        {
+            printk("can't read %s: %d\n", argv[3], r);
+            return 1;
+        }
+        bench::RunCapture(argv[2], capture);
+    }
+#else
+int main(void)
+{
+    uint32_t ops = kDefaultOps;
+#endif
+    bench::RunPrimitives(ops);
+    bench::RunDrivers(ops);
+    bench::RunGates(ops);
+    bench::RunFlashLog(ops);
+    bench::RunWire(ops);
+    bench::RunBaudrates(ops);
+    bench::RunBackend(ops);
+    bench::RunFilters(ops);
+    printk("{\"done\":true}\n");
+    return 0;
+}
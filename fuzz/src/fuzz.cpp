@@ -0,0 +1,67 @@
+#include "fuzz.h"
+#include <cstdlib>
+
+namespace fuzz
+{
+    /**********************************************************************/
+    /* Feeder                                                             */
+    /**********************************************************************/
+    Feeder::Feeder(uart::MemoryTransport &t, std::span<const uint8_t> data, When when):
+        m_Data(data.first(std::min(data.size(), kMaxInput)))
+    {
+        if (when == When::Now)
+            Feed(t);
+    }
+
+    void Feeder::OnTx(uart::MemoryTransport &t, const uint8_t *pData, size_t len)
+    {
+        if (!m_Fed)
+            Feed(t);
+    }
+
+    void Feeder::Feed(uart::MemoryTransport &t)
+    {
+        t.Feed(m_Data.data(), m_Data.size());
+        m_Fed = true;
+    }
+
+    /**********************************************************************/
+    /* Budget                                                             */
+    /**********************************************************************/
+    namespace
+    {
+        uint32_t budget_ms()
+        {
+            static const uint32_t ms = []{
+                constexpr uint32_t kDefaultBudgetMs = 100;
+                const char *pEnv = getenv("NRF_UART_FUZZ_BUDGET_MS");
+                return pEnv ? uint32_t(strtoul(pEnv, nullptr, 10)) : kDefaultBudgetMs;
+            }();
+            return ms;
+        }
+
+        uint64_t g_SlowestUs = 0;
+    }
+
+    Budget::Budget(const char *pTarget, std::span<const uint8_t> data):
+        m_pTarget(pTarget),
+        m_Data(data),
+        m_Start(k_cycle_get_64())
+    {
+    }
+
+    Budget::~Budget()
+    {
+        uint64_t us = k_cyc_to_us_floor64(k_cycle_get_64() - m_Start);
+        if (us > g_SlowestUs)
+        {
+            g_SlowestUs = us;
+            printk("#slowest %s: %llu us, %zu bytes\n", m_pTarget, (unsigned long long)us, m_Data.size());
+        }
+        if (us > uint64_t(budget_ms()) * 1000)
+        {
+            printk("%s: input of %zu bytes took %llu us (budget %u ms)\n", m_pTarget, m_Data.size(), (unsigned long long)us, budget_ms());
+            abort();
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef NRF_UART_FUZZ_H_
+#define NRF_UART_FUZZ_H_
+
+#include <nrf_uart/lib_uart.h>
+#include <nrf_uart/lib_uart_memory.h>
+#include <span>
+
+namespace fuzz
+{
+    //inputs are truncated to this; also the transport storage
+    static constexpr const size_t kMaxInput = 4096;
+
+    /**********************************************************************/
+    /* Feeder                                                             */
+    /* Hands the fuzz input to the channel: either right away (data       */
+    /* stream) or as the answer to the first command the driver sends.    */
+    /* End of stream is flagged, so every read past the input fails at    */
+    /* once instead of waiting for the driver timeout.                    */
+    /**********************************************************************/
+    class Feeder: public uart::MemoryTransport::Peer
+    {
+    public:
+        enum class When: uint8_t { Now, OnFirstTx };
+
+        Feeder(uart::MemoryTransport &t, std::span<const uint8_t> data, When when);
+
+        void OnTx(uart::MemoryTransport &t, const uint8_t *pData, size_t len) override;
+    private:
+        void Feed(uart::MemoryTransport &t);
+
+        std::span<const uint8_t> m_Data;
+        bool m_Fed = false;
+    };
+
+    /**********************************************************************/
+    /* Budget                                                             */
+    /* Times one input. With the stream closed nothing may legitimately    */
+    /* wait, so an input over budget is a slow path: it is reported and   */
+    /* the process aborts, which the fuzzer records like a crash.         */
+    /* NRF_UART_FUZZ_BUDGET_MS overrides the default.                     */
+    /**********************************************************************/
+    class Budget
+    {
+    public:
+        Budget(const char *pTarget, std::span<const uint8_t> data);
+        ~Budget();
+    private:
+        const char *m_pTarget;
+        std::span<const uint8_t> m_Data;
+        uint64_t m_Start;
+    };
+
+    template<class C>
+    struct Rig
+    {
+        uart::MemoryTransportStatic<kMaxInput> t;
+        Feeder feeder;
+        C c{t};
+
+        Rig(std::span<const uint8_t> data, Feeder::When when): feeder(t, data, when)
+        {
+            t.SetPeer(&feeder);
+            t.SetEndOfStream(true);
+        }
+    };
+}
+
+#endif
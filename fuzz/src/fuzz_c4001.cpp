@@ -0,0 +1,28 @@
+#include "fuzz.h"
+#include <nrf_uart/periphery/lib_dfr_c4001.h>
+
+//First byte selects the path, the rest is what the module "sends":
+//  even - $DFHPD/$DFDMD lines, read with TryReadFrame until the stream runs out
+//  odd  - shell responses, answered to Init (sensorStop + ReloadConfig)
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *pData, size_t size)
+{
+    if (!size)
+        return 0;
+    std::span<const uint8_t> in(pData + 1, size - 1);
+    fuzz::Budget budget("c4001", in);
+    if (pData[0] & 1)
+    {
+        fuzz::Rig<dfr::C4001> rig(in, fuzz::Feeder::When::OnFirstTx);
+        (void)rig.c.Init().has_value();
+    }else
+    {
+        fuzz::Rig<dfr::C4001> rig(in, fuzz::Feeder::When::Now);
+        (void)rig.c.Configure().has_value();
+        (void)rig.c.Open().has_value();
+        rig.c.StartContinuousReading();
+        //every attempt consumes at least one byte or fails at the end of stream
+        for(size_t i = 0; i <= in.size(); ++i)
+            (void)rig.c.TryReadFrame(1).has_value();
+    }
+    return 0;
+}
@@ -0,0 +1,29 @@
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+
+//Replays files through a target when it is not linked against libFuzzer:
+//regression runs over fuzz/corpus with any compiler, or AFL in file mode
+//(afl-fuzz ... -- ./nrf_uart_fuzz_ld2412 @@).
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *pData, size_t size);
+
+int main(int argc, char **argv)
+{
+    for(int i = 1; i < argc; ++i)
+    {
+        FILE *f = fopen(argv[i], "rb");
+        if (!f)
+        {
+            fprintf(stderr, "can't open %s\n", argv[i]);
+            return 1;
+        }
+        std::vector<uint8_t> data;
+        uint8_t buf[512];
+        for(size_t n; (n = fread(buf, 1, sizeof(buf), f)) > 0;)
+            data.insert(data.end(), buf, buf + n);
+        fclose(f);
+        printf("%s: %zu bytes\n", argv[i], data.size());
+        LLVMFuzzerTestOneInput(data.data(), data.size());
+    }
+    return 0;
+}
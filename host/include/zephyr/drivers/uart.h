@@ -0,0 +1,10 @@
+#ifndef NRF_UART_HOST_ZEPHYR_DRIVERS_UART_H_
+#define NRF_UART_HOST_ZEPHYR_DRIVERS_UART_H_
+
+//Host builds have no UART devices; uart::Channel is constructed from a
+//uart::Transport (see lib_uart_memory.h and host/lib_uart_posix.h)
+#include <zephyr/kernel.h>
+
+struct device;
+
+#endif
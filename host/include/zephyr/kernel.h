@@ -0,0 +1,164 @@
+#ifndef NRF_UART_HOST_ZEPHYR_KERNEL_H_
+#define NRF_UART_HOST_ZEPHYR_KERNEL_H_
+
+//Minimal subset of the Zephyr kernel API used by nrf_uart, implemented on
+//top of the C++ standard library for host (Linux) builds.
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdarg>
+#include <cerrno>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+struct k_timeout_t
+{
+    int64_t ms;//<0 - forever
+};
+
+#define Z_TIMEOUT_MS(t) (k_timeout_t{(int64_t)(t) < 0 ? -1 : (int64_t)(t)})
+#define K_MSEC(t) Z_TIMEOUT_MS(t)
+#define K_NO_WAIT (k_timeout_t{0})
+#define K_FOREVER (k_timeout_t{-1})
+#define SYS_FOREVER_US (-1)
+#define SYS_FOREVER_MS (-1)
+
+namespace nrf_uart_host
+{
+    using clock_t = std::chrono::steady_clock;
+    inline clock_t::time_point start_time()
+    {
+        static const clock_t::time_point t0 = clock_t::now();
+        return t0;
+    }
+}
+
+inline int64_t k_uptime_get()
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(nrf_uart_host::clock_t::now() - nrf_uart_host::start_time()).count();
+}
+inline uint32_t k_uptime_get_32() { return (uint32_t)k_uptime_get(); }
+
+//1 tick == 1us on host
+inline int64_t k_uptime_ticks()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(nrf_uart_host::clock_t::now() - nrf_uart_host::start_time()).count();
+}
+inline uint64_t k_ticks_to_us_floor64(uint64_t t) { return t; }
+
+//1 cycle == 1ns on host
+inline uint32_t sys_clock_hw_cycles_per_sec() { return 1'000'000'000; }
+inline uint64_t k_cycle_get_64()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(nrf_uart_host::clock_t::now() - nrf_uart_host::start_time()).count();
+}
+inline uint32_t k_cycle_get_32() { return (uint32_t)k_cycle_get_64(); }
+inline uint32_t k_cyc_to_us_floor32(uint32_t c) { return c / 1000; }
+inline uint64_t k_cyc_to_us_floor64(uint64_t c) { return c / 1000; }
+inline uint64_t k_cyc_to_ns_floor64(uint64_t c) { return c; }
+
+//NRF_UART_HOST_NO_SLEEP (fuzzing): drivers sleep only to pace real modules,
+//over a memory stream that is pure dead time
+inline int32_t k_msleep(int32_t ms)
+{
+#ifndef NRF_UART_HOST_NO_SLEEP
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+#endif
+    return 0;
+}
+inline void k_busy_wait(uint32_t us)
+{
+    auto end = nrf_uart_host::clock_t::now() + std::chrono::microseconds(us);
+    while(nrf_uart_host::clock_t::now() < end);
+}
+inline void k_yield() { std::this_thread::yield(); }
+
+inline int printk(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int r = vprintf(fmt, args);
+    va_end(args);
+    return r;
+}
+
+/**********************************************************************/
+/* k_sem                                                              */
+/**********************************************************************/
+struct k_sem
+{
+    std::mutex m;
+    std::condition_variable cv;
+    unsigned count = 0;
+    unsigned limit = 1;
+};
+
+inline int k_sem_init(k_sem *s, unsigned initial, unsigned limit)
+{
+    std::lock_guard l(s->m);
+    s->count = initial;
+    s->limit = limit;
+    return 0;
+}
+
+inline int k_sem_take(k_sem *s, k_timeout_t t)
+{
+    std::unique_lock l(s->m);
+    auto ready = [&]{ return s->count > 0; };
+    if (t.ms < 0)
+        s->cv.wait(l, ready);
+    else if (!s->cv.wait_for(l, std::chrono::milliseconds(t.ms), ready))
+        return t.ms ? -EAGAIN : -EBUSY;
+    --s->count;
+    return 0;
+}
+
+inline void k_sem_give(k_sem *s)
+{
+    {
+        std::lock_guard l(s->m);
+        if (s->count < s->limit)
+            ++s->count;
+    }
+    s->cv.notify_one();
+}
+
+inline void k_sem_reset(k_sem *s)
+{
+    std::lock_guard l(s->m);
+    s->count = 0;
+}
+
+inline unsigned k_sem_count_get(k_sem *s)
+{
+    std::lock_guard l(s->m);
+    return s->count;
+}
+
+/**********************************************************************/
+/* k_spinlock                                                         */
+/**********************************************************************/
+struct k_spinlock
+{
+    std::atomic_flag f = ATOMIC_FLAG_INIT;
+};
+struct k_spinlock_key_t { int key; };
+
+inline k_spinlock_key_t k_spin_lock(k_spinlock *l)
+{
+    while(l->f.test_and_set(std::memory_order_acquire));
+    return {0};
+}
+inline void k_spin_unlock(k_spinlock *l, k_spinlock_key_t)
+{
+    l->f.clear(std::memory_order_release);
+}
+
+#endif
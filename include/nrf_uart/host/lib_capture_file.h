@@ -0,0 +1,40 @@
+#ifndef LIB_CAPTURE_FILE_H_
+#define LIB_CAPTURE_FILE_H_
+
+#include "../lib_capture.h"
+#include <cstdio>
+#include <vector>
+
+namespace uart
+{
+    namespace capture
+    {
+        /**********************************************************************/
+        /* FileSink                                                           */
+        /* Host sink writing a capture file. Records are flushed by stdio;    */
+        /* call Flush before reading the file back while still capturing.     */
+        /**********************************************************************/
+        class FileSink: public Sink
+        {
+        public:
+            FileSink() = default;
+            ~FileSink();
+
+            //creates/truncates the file and writes kMagic; returns 0 or -errno
+            int Open(const char *pPath);
+            void Close();
+            void Flush();
+
+            bool IsOpen() const { return m_pFile != nullptr; }
+
+            void Write(const uint8_t *pRecord, size_t len) override;
+        private:
+            FILE *m_pFile = nullptr;
+        };
+
+        //reads a whole capture file; returns 0 or -errno
+        int load_file(const char *pPath, std::vector<uint8_t> &dst);
+    }
+}
+
+#endif
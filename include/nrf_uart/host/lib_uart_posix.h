@@ -0,0 +1,46 @@
+#ifndef LIB_UART_POSIX_H_
+#define LIB_UART_POSIX_H_
+
+#include "../lib_uart_transport.h"
+
+namespace uart
+{
+    /**********************************************************************/
+    /* PosixFd                                                            */
+    /* Host transport over a file descriptor: serial tty, pty or          */
+    /* socketpair. Polled via poll(2), sends are synchronous.             */
+    /**********************************************************************/
+    class PosixFd: public Transport
+    {
+    public:
+        //does not take ownership of fd
+        PosixFd(int fd): m_Fd(fd) {}
+
+        //opens a tty in raw 8N1 mode; returns fd or -errno
+        //baudrate may be any rate the tty accepts (e.g. the LD2412's 256000), 0 keeps the current one
+        static int open_tty(const char *pPath, uint32_t baudrate);
+        //opens a pty pair in raw mode; pSlaveName receives the slave path
+        static int open_pty(int &master, int &slave, char *pSlaveName = nullptr, size_t nameLen = 0);
+
+        int Send(const uint8_t *pData, size_t len) override;
+        int StartRx() override { m_RxActive = true; return 0; }
+        int StopRx() override { m_RxActive = false; return 0; }
+        bool IsRxActive() const override { return m_RxActive; }
+
+        bool IsPolled() const override { return true; }
+        int Poll(duration_ms_t maxWait) override;
+
+        uint32_t GetBaudrate() const override;
+        int SetBaudrate(uint32_t baudrate) override;
+    private:
+        //termios2/BOTHER (lib_uart_posix_speed.cpp): arbitrary rates, not only the Bxxx table
+        //set_speed returns 0 or -errno, get_speed 0 on error
+        static int set_speed(int fd, uint32_t baudrate);
+        static uint32_t get_speed(int fd);
+
+        int m_Fd;
+        bool m_RxActive = false;
+    };
+}
+
+#endif
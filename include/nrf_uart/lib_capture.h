@@ -0,0 +1,137 @@
+#ifndef LIB_CAPTURE_H_
+#define LIB_CAPTURE_H_
+
+#include <zephyr/kernel.h>
+#include <cstdint>
+#include <cstddef>
+#include <span>
+
+namespace uart
+{
+    namespace capture
+    {
+        /**********************************************************************/
+        /* Format                                                             */
+        /* A capture is kMagic followed by records:                           */
+        /*   u8     bit7 - direction (1 = tx), bits 0..6 - data length - 1    */
+        /*   varint microseconds since the previous record (LEB128, u32)      */
+        /*   u8[]   data                                                      */
+        /* Longer chunks are split into several records. The first record's   */
+        /* delta is meaningless once a ring has dropped older ones.           */
+        /**********************************************************************/
+        static constexpr const uint8_t kMagic[] = {'N', 'U', 'C', '1'};
+        static constexpr const size_t kMaxRecordData = 128;
+        static constexpr const size_t kMaxRecordHeader = 1 + 5;
+
+        enum class Dir: uint8_t { Rx, Tx };
+
+        struct Record
+        {
+            Dir dir;
+            uint32_t deltaUs;
+            std::span<const uint8_t> data;
+        };
+
+        inline uint64_t now_us() { return k_ticks_to_us_floor64(k_uptime_ticks()); }
+
+        //walks the records of a capture (with kMagic in front)
+        class Reader
+        {
+        public:
+            Reader(std::span<const uint8_t> capture);
+
+            //false if the magic is missing
+            bool Valid() const { return m_Valid; }
+            //false at the end or on a truncated record
+            bool Next(Record &r);
+            void Rewind() { m_Pos = sizeof(kMagic); }
+        private:
+            std::span<const uint8_t> m_Data;
+            size_t m_Pos = 0;
+            bool m_Valid = false;
+        };
+
+        /**********************************************************************/
+        /* Sink                                                               */
+        /* Receives encoded records, one whole record per call. Called under  */
+        /* the recorder lock, possibly from ISR context.                      */
+        /**********************************************************************/
+        class Sink
+        {
+        public:
+            virtual ~Sink() = default;
+            virtual void Write(const uint8_t *pRecord, size_t len) = 0;
+        };
+
+        /**********************************************************************/
+        /* Ring                                                               */
+        /* RAM sink that keeps the newest records, dropping whole records     */
+        /* from the oldest end.                                               */
+        /**********************************************************************/
+        class Ring: public Sink
+        {
+        public:
+            Ring(std::span<uint8_t> storage): m_Storage(storage) {}
+
+            void Write(const uint8_t *pRecord, size_t len) override;
+
+            void Clear() { m_Head = m_Used = 0; m_Dropped = 0; }
+            size_t Used() const { return m_Used; }
+            uint32_t Dropped() const { return m_Dropped; }
+
+            //linear capture (kMagic + records) into dst; returns the length or 0 if dst is too small
+            size_t CopyOut(std::span<uint8_t> dst) const;
+
+            //hex dump of the linear capture for pulling it over a console:
+            //  "CAP <bytes>" followed by lines of hex; `tail -n +2 | xxd -r -p` restores the file
+            void Dump() const;
+        private:
+            uint8_t At(size_t i) const { return m_Storage[(m_Head + i) % m_Storage.size()]; }
+            void DropOldest();
+
+            std::span<uint8_t> m_Storage;
+            size_t m_Head = 0;
+            size_t m_Used = 0;
+            uint32_t m_Dropped = 0;
+        };
+
+        template<size_t N>
+        class RingStatic: public Ring
+        {
+        public:
+            RingStatic(): Ring(m_Bytes) {}
+        private:
+            uint8_t m_Bytes[N];
+        };
+
+        /**********************************************************************/
+        /* Recorder                                                           */
+        /* Timestamps and encodes both directions of a Channel into a Sink.   */
+        /* Attach with Channel::SetCapture. Add may be called from ISR.       */
+        /**********************************************************************/
+        class Recorder
+        {
+        public:
+            struct Stats
+            {
+                uint32_t records = 0;
+                uint32_t rxBytes = 0;
+                uint32_t txBytes = 0;
+            };
+
+            Recorder(Sink &sink): m_Sink(sink) {}
+
+            void Add(Dir d, const uint8_t *pData, size_t len);
+
+            Stats const& GetStats() const { return m_Stats; }
+        private:
+            Sink &m_Sink;
+            k_spinlock m_Lock{};
+            uint64_t m_LastUs = 0;
+            bool m_First = true;
+            Stats m_Stats;
+        };
+    }
+}
+
+#endif
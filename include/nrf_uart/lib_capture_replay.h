@@ -0,0 +1,98 @@
+#ifndef LIB_CAPTURE_REPLAY_H_
+#define LIB_CAPTURE_REPLAY_H_
+
+#include "lib_capture.h"
+#include "lib_uart_memory.h"
+
+namespace uart
+{
+    namespace capture
+    {
+        /**********************************************************************/
+        /* Replay                                                             */
+        /* MemoryTransport peer that plays the rx side of a capture back to   */
+        /* a driver. Captured tx records act as sync points: the rx that      */
+        /* followed them is held back until the driver has sent as many       */
+        /* bytes, and the original timing restarts from that moment. What    */
+        /* the driver sends is compared with the captured tx.                 */
+        /* Original - rx records are spaced as captured                       */
+        /* Max      - rx is delivered as fast as the channel takes it; a sync */
+        /*            point the driver doesn't reach within kStallUs (e.g.    */
+        /*            a command issued in the field the replayed driver      */
+        /*            never sends) is skipped and counted in Stats::stalls    */
+        /**********************************************************************/
+        class Replay: public MemoryTransport::Peer
+        {
+        public:
+            enum class Speed: uint8_t { Original, Max };
+
+            //Speed::Max: wall time without tx progress after which a sync point is skipped
+            static constexpr const uint64_t kStallUs = 200'000;
+
+            struct Stats
+            {
+                uint32_t rxBytes = 0;
+                uint32_t txBytes = 0;
+                //driver tx differing from (or beyond) the captured tx
+                uint32_t txMismatch = 0;
+                //sync points skipped and the captured tx bytes they waited for
+                uint32_t stalls = 0;
+                uint32_t txSkipped = 0;
+            };
+
+            //the capture must outlive the replay; at the end the transport
+            //is put into end of stream unless eosAtEnd is false
+            Replay(std::span<const uint8_t> capture, Speed speed = Speed::Original, bool eosAtEnd = true);
+
+            bool Valid() const { return m_Rx.Valid(); }
+            bool Done() const { return m_Done; }
+            //back to the first record; the transport end of stream is left as is
+            void Rewind();
+
+            Stats const& GetStats() const { return m_Stats; }
+
+            void OnTx(MemoryTransport &t, const uint8_t *pData, size_t len) override;
+            void OnPoll(MemoryTransport &t) override;
+        private:
+            bool NextRx();
+            bool NextTx();
+            void SkipTx(uint64_t n);
+
+            //rx side: next record to deliver and how much of it went out
+            Reader m_Rx;
+            Record m_Cur{};
+            bool m_HasCur = false;
+            size_t m_CurSent = 0;
+            uint64_t m_CurCapUs = 0;//capture time of m_Cur
+            uint64_t m_CurTxBefore = 0;//captured tx bytes preceding m_Cur
+            uint64_t m_CurTxCapUs = 0;//capture time of the last tx record preceding m_Cur
+            uint64_t m_CapUs = 0;
+            uint64_t m_CapTx = 0;
+            uint64_t m_CapTxUs = 0;
+            bool m_FirstRecord = true;
+
+            //tx side: captured tx bytes the driver is compared against
+            Reader m_Tx;
+            Record m_TxRec{};
+            size_t m_TxPos = 0;
+            uint64_t m_TxSeen = 0;
+            uint64_t m_TxWallUs = 0;
+            uint64_t m_TxSkipped = 0;//counts as seen: the sync points stalled on
+            uint64_t m_WaitWallUs = 0;//since when the current sync point is waited for
+            bool m_Waiting = false;
+
+            //capture time that corresponds to wall time m_SyncWallUs
+            uint64_t m_SyncCapUs = 0;
+            uint64_t m_SyncWallUs = 0;
+            uint64_t m_SyncTx = 0;
+            bool m_Started = false;
+
+            Speed m_Speed;
+            bool m_EosAtEnd;
+            bool m_Done = false;
+            Stats m_Stats;
+        };
+    }
+}
+
+#endif
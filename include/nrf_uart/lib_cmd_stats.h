@@ -0,0 +1,139 @@
+#ifndef LIB_CMD_STATS_H_
+#define LIB_CMD_STATS_H_
+
+#include <zephyr/kernel.h>
+#include <lib_formatter.hpp>
+#include <cstdint>
+#include <limits>
+#include <array>
+#include <algorithm>
+
+namespace uart
+{
+    /**********************************************************************/
+    /* cmd_stat_t                                                         */
+    /**********************************************************************/
+    struct cmd_stat_t
+    {
+        uint32_t count = 0;
+        uint32_t retries = 0;
+        uint32_t failures = 0;
+        uint32_t min_us = std::numeric_limits<uint32_t>::max();
+        uint32_t max_us = 0;
+        uint64_t total_us = 0;
+
+        uint32_t avg_us() const { return count ? uint32_t(total_us / count) : 0; }
+    };
+
+    template<class Key>
+    struct cmd_stats_entry_t
+    {
+        Key key{};
+        cmd_stat_t stat;
+    };
+
+    /**********************************************************************/
+    /* CmdStats                                                           */
+    /* Fixed-size per-command round-trip table. Key is anything           */
+    /* comparable (command id, command string_view). When the table is    */
+    /* full new keys are silently not recorded.                           */
+    /**********************************************************************/
+    template<class Key, size_t N>
+    class CmdStats
+    {
+    public:
+        using Entry = cmd_stats_entry_t<Key>;
+
+        class Probe
+        {
+        public:
+            Probe(CmdStats &s, Key k): m_S(s), m_Key(k), m_Start(k_cycle_get_32()) {}
+            Probe(Probe const&) = delete;
+            Probe& operator=(Probe const&) = delete;
+            ~Probe() { if (!m_Done) m_S.Record(m_Key, m_Start, m_Retries, false); }
+
+            void Retry() { ++m_Retries; }
+            void Success() { m_Done = true; m_S.Record(m_Key, m_Start, m_Retries, true); }
+        private:
+            CmdStats &m_S;
+            Key m_Key;
+            uint32_t m_Start;
+            uint32_t m_Retries = 0;
+            bool m_Done = false;
+        };
+
+        Probe Start(Key k) { return Probe(*this, k); }
+
+        const Entry* Find(Key k) const
+        {
+            for(size_t i = 0; i < m_Used; ++i)
+                if (m_Entries[i].key == k) return &m_Entries[i];
+            return nullptr;
+        }
+
+        void Reset() { m_Used = 0; }
+
+        size_t size() const { return m_Used; }
+        const Entry* begin() const { return m_Entries.data(); }
+        const Entry* end() const { return m_Entries.data() + m_Used; }
+
+    private:
+        void Record(Key k, uint32_t start, uint32_t retries, bool ok)
+        {
+            Entry *pE = nullptr;
+            for(size_t i = 0; i < m_Used; ++i)
+            {
+                if (m_Entries[i].key == k)
+                {
+                    pE = &m_Entries[i];
+                    break;
+                }
+            }
+            if (!pE)
+            {
+                if (m_Used == N)
+                    return;
+                pE = &m_Entries[m_Used++];
+                *pE = Entry{k, {}};
+            }
+
+            uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+            auto &s = pE->stat;
+            ++s.count;
+            s.retries += retries;
+            if (!ok) ++s.failures;
+            s.total_us += us;
+            s.min_us = std::min(s.min_us, us);
+            s.max_us = std::max(s.max_us, us);
+        }
+
+        std::array<Entry, N> m_Entries;
+        size_t m_Used = 0;
+    };
+}
+
+namespace tools{
+template<>
+struct formatter_t<uart::cmd_stat_t>
+{
+    template<FormatDestination Dest>
+    static std::expected<size_t, FormatError> format_to(Dest &&dst, std::string_view const& fmtStr, uart::cmd_stat_t const& s)
+    {
+        return tools::format_to(std::forward<Dest>(dst), "n={} retries={} failed={} rtt(us) min/avg/max={}/{}/{}"
+                , s.count, s.retries, s.failures
+                , s.count ? s.min_us : 0, s.avg_us(), s.max_us);
+    }
+};
+
+template<class Key>
+struct formatter_t<uart::cmd_stats_entry_t<Key>>
+{
+    template<FormatDestination Dest>
+    static std::expected<size_t, FormatError> format_to(Dest &&dst, std::string_view const& fmtStr, uart::cmd_stats_entry_t<Key> const& e)
+    {
+        return tools::format_to(std::forward<Dest>(dst), "cmd {}: {}", e.key, e.stat);
+    }
+};
+}
+
+#endif
@@ -0,0 +1,144 @@
+#ifndef LIB_FRAME_QUEUE_H_
+#define LIB_FRAME_QUEUE_H_
+
+#include <zephyr/kernel.h>
+#include <cstdint>
+#include <cstddef>
+#include <span>
+
+namespace uart
+{
+    /**********************************************************************/
+    /* FrameQueue                                                         */
+    /* Bounded queue of decoded frames between the reading thread and a   */
+    /* consumer. What happens when the consumer falls behind is chosen    */
+    /* by the overflow policy:                                            */
+    /*   DropOldest - the oldest queued frame makes room (recent history) */
+    /*   DropNewest - the incoming frame is discarded (no gaps up front)  */
+    /*   Conflate   - everything queued is discarded, the consumer        */
+    /*                resumes at the latest frame                         */
+    /* Push may be called from ISR context, Pop may block.                */
+    /**********************************************************************/
+    enum class Overflow: uint8_t { DropOldest, DropNewest, Conflate };
+
+    template<class T>
+    class FrameQueue
+    {
+    public:
+        struct Stats
+        {
+            uint32_t pushed = 0;
+            uint32_t popped = 0;
+            uint32_t dropped = 0;
+            uint32_t highWater = 0;
+        };
+
+        FrameQueue(std::span<T> storage, Overflow policy = Overflow::DropOldest):
+            m_Storage(storage),
+            m_Policy(policy)
+        {
+            k_sem_init(&m_Ready, 0, 1);
+        }
+
+        void SetPolicy(Overflow policy) { m_Policy = policy; }
+        Overflow GetPolicy() const { return m_Policy; }
+
+        //false if v itself was dropped (DropNewest on a full queue)
+        bool Push(T const& v)
+        {
+            k_spinlock_key_t key = k_spin_lock(&m_Lock);
+            ++m_Stats.pushed;
+            if (m_Count == m_Storage.size())
+            {
+                switch(m_Policy)
+                {
+                    case Overflow::DropOldest:
+                        m_Head = (m_Head + 1) % m_Storage.size();
+                        --m_Count;
+                        ++m_Stats.dropped;
+                        break;
+                    case Overflow::DropNewest:
+                        ++m_Stats.dropped;
+                        k_spin_unlock(&m_Lock, key);
+                        return false;
+                    case Overflow::Conflate:
+                        m_Stats.dropped += m_Count;
+                        m_Count = 0;
+                        break;
+                }
+            }
+            m_Storage[(m_Head + m_Count) % m_Storage.size()] = v;
+            ++m_Count;
+            if (m_Count > m_Stats.highWater)
+                m_Stats.highWater = m_Count;
+            k_spin_unlock(&m_Lock, key);
+            k_sem_give(&m_Ready);
+            return true;
+        }
+
+        //waits up to `wait` for a frame; false if none arrived
+        bool Pop(T &dst, k_timeout_t wait = K_NO_WAIT)
+        {
+            while(true)
+            {
+                k_spinlock_key_t key = k_spin_lock(&m_Lock);
+                if (m_Count)
+                {
+                    dst = m_Storage[m_Head];
+                    m_Head = (m_Head + 1) % m_Storage.size();
+                    --m_Count;
+                    ++m_Stats.popped;
+                    k_spin_unlock(&m_Lock, key);
+                    return true;
+                }
+                k_spin_unlock(&m_Lock, key);
+                //the semaphore only signals "pushed since"; the queue is rechecked after it
+                if (k_sem_take(&m_Ready, wait) != 0)
+                    return false;
+            }
+        }
+
+        void Clear()
+        {
+            k_spinlock_key_t key = k_spin_lock(&m_Lock);
+            m_Head = m_Count = 0;
+            k_spin_unlock(&m_Lock, key);
+        }
+
+        size_t Size() const { return m_Count; }
+        size_t Capacity() const { return m_Storage.size(); }
+
+        Stats GetStats() const
+        {
+            k_spinlock_key_t key = k_spin_lock(&m_Lock);
+            Stats s = m_Stats;
+            k_spin_unlock(&m_Lock, key);
+            return s;
+        }
+        void ResetStats()
+        {
+            k_spinlock_key_t key = k_spin_lock(&m_Lock);
+            m_Stats = {};
+            k_spin_unlock(&m_Lock, key);
+        }
+    private:
+        std::span<T> m_Storage;
+        Overflow m_Policy;
+        size_t m_Head = 0;
+        size_t m_Count = 0;
+        Stats m_Stats;
+        mutable k_spinlock m_Lock{};
+        k_sem m_Ready;
+    };
+
+    template<class T, size_t N>
+    class FrameQueueStatic: public FrameQueue<T>
+    {
+    public:
+        FrameQueueStatic(Overflow policy = Overflow::DropOldest): FrameQueue<T>(m_Frames, policy) {}
+    private:
+        T m_Frames[N];
+    };
+}
+
+#endif
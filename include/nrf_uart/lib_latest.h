@@ -0,0 +1,89 @@
+#ifndef LIB_LATEST_H_
+#define LIB_LATEST_H_
+
+#include <zephyr/kernel.h>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace uart
+{
+    /**********************************************************************/
+    /* Latest                                                             */
+    /* Latest-value publication from one writer to any number of readers  */
+    /* (seqcount latch). The value is kept twice; while the writer        */
+    /* updates one copy readers take the other, so a reader never waits  */
+    /* for a writer it preempted. A reader only retries if a publication   */
+    /* completed while it was copying. Neither side locks or blocks.      */
+    /**********************************************************************/
+    template<class T>
+    class Latest
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "published by copying words");
+    public:
+        struct Snapshot
+        {
+            T value{};
+            uint32_t seq = 0;//1 for the first publication, 0 - nothing published yet
+            int64_t uptimeMs = 0;//k_uptime_get at publication
+        };
+
+        //writer side (single thread); returns what readers will see
+        Snapshot Publish(T const& v)
+        {
+            Snapshot s{v, ++m_Published, k_uptime_get()};
+            uint32_t w[kWords] = {};
+            memcpy(w, &s, sizeof(s));
+
+            uint32_t seq = m_Seq.load(std::memory_order_relaxed);
+            //odd: readers switch to copy 1 while copy 0 is written
+            m_Seq.store(seq + 1, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_release);
+            Store(0, w);
+            m_Seq.store(seq + 2, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_release);
+            Store(1, w);
+            return s;
+        }
+
+        //reader side (any thread)
+        Snapshot Read() const
+        {
+            uint32_t w[kWords];
+            uint32_t before, after;
+            do
+            {
+                before = m_Seq.load(std::memory_order_acquire);
+                Load(before & 1, w);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                after = m_Seq.load(std::memory_order_relaxed);
+            }while(before != after);
+            Snapshot s;
+            memcpy(&s, w, sizeof(s));
+            return s;
+        }
+
+        //number of publications so far
+        uint32_t Sequence() const { return m_Seq.load(std::memory_order_relaxed) / 2; }
+    private:
+        static constexpr const size_t kWords = (sizeof(Snapshot) + 3) / 4;
+
+        void Store(int copy, const uint32_t *pW)
+        {
+            for(size_t i = 0; i < kWords; ++i)
+                m_Copies[copy][i].store(pW[i], std::memory_order_relaxed);
+        }
+        void Load(int copy, uint32_t *pW) const
+        {
+            for(size_t i = 0; i < kWords; ++i)
+                pW[i] = m_Copies[copy][i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic<uint32_t> m_Seq{0};
+        std::atomic<uint32_t> m_Copies[2][kWords] = {};
+        uint32_t m_Published = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef LIB_TRACE_H_
+#define LIB_TRACE_H_
+
+#include <zephyr/kernel.h>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <span>
+
+namespace uart
+{
+    namespace trace
+    {
+        /**********************************************************************/
+        /* Event                                                              */
+        /* Payload layout (little endian, truncated to kPayloadSize) is given */
+        /* next to each id. Ids are stable: offline decoders depend on them.  */
+        /**********************************************************************/
+        enum class Event: uint8_t
+        {
+            None            = 0x00,
+
+            //Channel
+            TxStart         = 0x01,//u16 len, u8[4] first bytes
+            RxEnable        = 0x02,//i16 result, u16 buf len
+            RxDisable       = 0x03,//i16 result
+            RxRestart       = 0x04,//
+            RxRead          = 0x05,//u16 requested, u16 available before blocking
+            RxTimeout       = 0x06,//u16 write pos, u16 read pos, u8 rx active
+            RxOverflow      = 0x07,//u16 write pos, u16 read pos
+            Drain           = 0x08,//
+
+            //LD2412
+            CmdSend         = 0x20,//u16 cmd
+            CmdRetry        = 0x21,//u16 cmd, u8 attempt
+            CmdStatus       = 0x22,//u16 cmd, u16 status
+            CmdFailed       = 0x23,//u16 cmd
+            FrameLen        = 0x24,//u16 len
+            FrameFooter     = 0x25,//
+            DataFrame       = 0x26,//u16 report len, u8 mode, u8 target state
+            DataFrameErr    = 0x27,//u8 configured mode
+
+            //C4001
+            StrCmdSend      = 0x40,//char[6] command prefix
+            StrCmdParams    = 0x41,//
+            StrCmdDone      = 0x42,//u8 0=Done,1=Error
+            StrDataFrame    = 0x43,//u8 0=presence,1=target, u8 presence/target count
+            StrDataFrameErr = 0x44,//u8 app mode
+        };
+
+        const char* event_to_str(Event e);
+
+        static constexpr const size_t kPayloadSize = 6;
+
+#pragma pack(push,1)
+        struct entry_t
+        {
+            uint32_t ts;//k_cycle_get_32
+            Event ev;
+            uint8_t len;
+            uint8_t payload[kPayloadSize];
+        };
+#pragma pack(pop)
+        static_assert(sizeof(entry_t) == 12, "entry_t is part of the dump format");
+
+        /**********************************************************************/
+        /* Ring                                                               */
+        /* Lock-free overwrite-oldest ring of entry_t. Add may be called from */
+        /* ISR context.                                                       */
+        /**********************************************************************/
+        class Ring
+        {
+        public:
+            Ring(std::span<entry_t> storage): m_Storage(storage) {}
+
+            template<class... T>
+            void Add(Event e, T const&... v)
+            {
+                uint32_t idx = m_Next.fetch_add(1, std::memory_order_relaxed);
+                entry_t &dst = m_Storage[idx % m_Storage.size()];
+                dst.ts = k_cycle_get_32();
+                dst.ev = e;
+                uint8_t l = 0;
+                if constexpr (sizeof...(T) > 0)
+                {
+                    auto put = [&](auto const& a)
+                    {
+                        size_t n = std::min(sizeof(a), kPayloadSize - l);
+                        memcpy(dst.payload + l, &a, n);
+                        l += n;
+                    };
+                    (put(v), ...);
+                }
+                dst.len = l;
+            }
+
+            void AddBytes(Event e, const uint8_t *pData, size_t len)
+            {
+                uint32_t idx = m_Next.fetch_add(1, std::memory_order_relaxed);
+                entry_t &dst = m_Storage[idx % m_Storage.size()];
+                dst.ts = k_cycle_get_32();
+                dst.ev = e;
+                dst.len = std::min(len, kPayloadSize);
+                memcpy(dst.payload, pData, dst.len);
+            }
+
+            void Clear() { m_Next.store(0, std::memory_order_relaxed); }
+
+            //total entries ever added; the ring holds the last min(Total, capacity)
+            uint32_t Total() const { return m_Next.load(std::memory_order_relaxed); }
+            size_t Capacity() const { return m_Storage.size(); }
+
+            //oldest to newest
+            template<class CB>
+            void ForEach(CB &&cb) const
+            {
+                uint32_t end = Total();
+                uint32_t begin = end > m_Storage.size() ? end - m_Storage.size() : 0;
+                for(uint32_t i = begin; i < end; ++i)
+                    cb(m_Storage[i % m_Storage.size()]);
+            }
+
+            //text dump for offline decoding, independent of entry_t's in-memory layout:
+            //  "TRC <cycles per sec> <count>" followed by <count> lines, oldest first:
+            //  "<ts, 8 hex> <event id, 2 hex> <payload len> <payload, 2*len hex; '-' if len is 0> <event name>"
+            //the payload bytes are as described next to each Event id
+            void Dump() const;
+        private:
+            std::span<entry_t> m_Storage;
+            std::atomic<uint32_t> m_Next{0};
+        };
+
+        template<size_t N>
+        class RingStatic: public Ring
+        {
+        public:
+            RingStatic(): Ring(m_Entries) {}
+        private:
+            entry_t m_Entries[N];
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,192 @@
+#ifndef LIB_TRACK_FILTERS_H_
+#define LIB_TRACK_FILTERS_H_
+
+#include <cstdint>
+#include <algorithm>
+
+namespace uart
+{
+    namespace filters
+    {
+        /**********************************************************************/
+        /* Distance filters                                                   */
+        /* Smoothed distance (cm) and velocity (cm/s, positive = receding)    */
+        /* from irregularly spaced range readings. State is 24.8 fixed point, */
+        /* tuning is in template arguments, so a filter that is not named     */
+        /* anywhere is not compiled in. Cost per Update:                      */
+        /*   Ema       - 1 division                                           */
+        /*   AlphaBeta - 2 divisions                                          */
+        /*   Kalman    - 2 64 bit divisions, ~20 64 bit multiplications       */
+        /* All share: Reset(z) starts at a measurement, Update(z, dtMs).      */
+        /**********************************************************************/
+        struct Estimate
+        {
+            int32_t distance = 0;//cm
+            int32_t velocity = 0;//cm/s
+        };
+
+        namespace detail
+        {
+            static constexpr const int kFrac = 8;
+            static constexpr const int32_t kOne = 1 << kFrac;
+
+            constexpr int32_t round_q(int64_t v) { return int32_t((v + (v >= 0 ? kOne / 2 : -kOne / 2)) / kOne); }
+            //dt of 0 (two readings in the same millisecond) would divide by zero,
+            //longer than 10s could overflow the Kalman covariance prediction
+            constexpr int32_t safe_dt(uint32_t dtMs) { return int32_t(std::clamp<uint32_t>(dtMs, 1, 10000)); }
+        }
+
+        //exponential moving average of the distance, velocity from its slope (alpha = 2^-Shift)
+        template<uint8_t Shift>
+        class Ema
+        {
+            static_assert(Shift < 16);
+        public:
+            void Reset(int32_t z)
+            {
+                m_X = z * detail::kOne;
+                m_V = 0;
+            }
+            Estimate Update(int32_t z, uint32_t dtMs)
+            {
+                int32_t prev = m_X;
+                m_X += (z * detail::kOne - m_X) >> Shift;
+                int32_t slope = int32_t(int64_t(m_X - prev) * 1000 / detail::safe_dt(dtMs));
+                m_V += (slope - m_V) >> Shift;
+                return Get();
+            }
+            Estimate Get() const { return {detail::round_q(m_X), detail::round_q(m_V)}; }
+        private:
+            int32_t m_X = 0;//cm 24.8
+            int32_t m_V = 0;//cm/s 24.8
+        };
+
+        //g-h filter: constant velocity prediction corrected by the residual
+        //with fixed gains AlphaQ8/256 (position) and BetaQ8/256 (velocity)
+        template<uint16_t AlphaQ8, uint16_t BetaQ8>
+        class AlphaBeta
+        {
+            static_assert(AlphaQ8 <= 256 && BetaQ8 <= 256);
+        public:
+            void Reset(int32_t z)
+            {
+                m_X = z * detail::kOne;
+                m_V = 0;
+            }
+            Estimate Update(int32_t z, uint32_t dtMs)
+            {
+                const int32_t dt = detail::safe_dt(dtMs);
+                int64_t predicted = m_X + int64_t(m_V) * dt / 1000;
+                int64_t r = int64_t(z) * detail::kOne - predicted;
+                m_X = int32_t(predicted + ((r * AlphaQ8) >> 8));
+                m_V = int32_t(m_V + ((r * BetaQ8) >> 8) * 1000 / dt);
+                return Get();
+            }
+            Estimate Get() const { return {detail::round_q(m_X), detail::round_q(m_V)}; }
+        private:
+            int32_t m_X = 0;
+            int32_t m_V = 0;
+        };
+
+        //constant velocity Kalman filter; AccelNoise - std dev of the unmodelled
+        //acceleration (cm/s^2), MeasNoise - std dev of a reading (cm). The gain
+        //follows the covariance, so it converges fast after Reset and adapts to dt.
+        template<uint16_t AccelNoise, uint16_t MeasNoise>
+        class Kalman
+        {
+            static_assert(MeasNoise > 0);
+            //covariances in cm^2, cm^2/s, cm^2/s^2; times are seconds in 16.16
+            static constexpr const int64_t kQ = int64_t(AccelNoise) * AccelNoise;
+            static constexpr const int64_t kR = int64_t(MeasNoise) * MeasNoise;
+            static constexpr const int kT = 16;
+            static constexpr const int64_t kMaxP = int64_t(1) << 30;//keeps every product below 2^63
+        public:
+            void Reset(int32_t z)
+            {
+                m_X = z * detail::kOne;
+                m_V = 0;
+                m_P00 = kR;
+                m_P01 = 0;
+                m_P11 = std::min<int64_t>(kR * 100, kMaxP);//velocity unknown: up to ~10x the noise per 1/10 s
+            }
+            Estimate Update(int32_t z, uint32_t dtMs)
+            {
+                const int64_t t = (int64_t(detail::safe_dt(dtMs)) << kT) / 1000;
+                const int64_t t2 = (t * t) >> kT;
+                const int64_t t3 = (t2 * t) >> kT;
+                const int64_t t4 = (t3 * t) >> kT;
+
+                //predict
+                int64_t x = m_X + ((int64_t(m_V) * t) >> kT);
+                int64_t p00 = Limit(m_P00 + ((t * (2 * m_P01 + ((m_P11 * t) >> kT))) >> kT) + ((kQ * t4) >> (kT + 2)), 1);
+                int64_t p01 = Limit(m_P01 + ((m_P11 * t) >> kT) + ((kQ * t3) >> (kT + 1)), -kMaxP);
+                int64_t p11 = Limit(m_P11 + ((kQ * t2) >> kT), 1);
+
+                //update; gains in 16.16 (k1 in 1/s)
+                const int64_t s = p00 + kR;
+                const int64_t k0 = (p00 << kT) / s;
+                const int64_t k1 = (p01 << kT) / s;
+                const int64_t y = int64_t(z) * detail::kOne - x;
+                m_X = int32_t(x + ((k0 * y) >> kT));
+                m_V = int32_t(m_V + ((k1 * y) >> kT));
+                m_P00 = Limit(p00 - ((k0 * p00) >> kT), 1);
+                m_P01 = Limit(p01 - ((k0 * p01) >> kT), -kMaxP);
+                m_P11 = Limit(p11 - ((k1 * p01) >> kT), 1);
+                return Get();
+            }
+            Estimate Get() const { return {detail::round_q(m_X), detail::round_q(m_V)}; }
+        private:
+            static int64_t Limit(int64_t v, int64_t lo) { return std::clamp<int64_t>(v, lo, kMaxP); }
+
+            int32_t m_X = 0;
+            int32_t m_V = 0;
+            int64_t m_P00 = kR;
+            int64_t m_P01 = 0;
+            int64_t m_P11 = 0;
+        };
+
+        /**********************************************************************/
+        /* Track                                                              */
+        /* Runs a filter over the readings of one target: (re)starts it on    */
+        /* the first reading after the target was absent or after a gap of    */
+        /* more than maxGapMs, so it never smooths across two targets.        */
+        /**********************************************************************/
+        template<class F>
+        class Track
+        {
+        public:
+            Track(uint32_t maxGapMs = 2000): m_MaxGapMs(maxGapMs) {}
+
+            //present == false drops the track; returns whether it is valid
+            bool Add(bool present, int32_t z, int64_t nowMs)
+            {
+                if (!present)
+                {
+                    m_Valid = false;
+                    return false;
+                }
+                if (!m_Valid || nowMs - m_LastMs > m_MaxGapMs)
+                {
+                    m_Filter.Reset(z);
+                    m_Est = m_Filter.Get();
+                }else
+                    m_Est = m_Filter.Update(z, uint32_t(nowMs - m_LastMs));
+                m_LastMs = nowMs;
+                m_Valid = true;
+                return true;
+            }
+
+            bool Valid() const { return m_Valid; }
+            Estimate const& Get() const { return m_Est; }
+            F& GetFilter() { return m_Filter; }
+        private:
+            F m_Filter;
+            Estimate m_Est;
+            int64_t m_LastMs = 0;
+            uint32_t m_MaxGapMs;
+            bool m_Valid = false;
+        };
+    }
+}
+
+#endif
@@ -5,13 +5,36 @@
 #define FORCE_FMT
 #define PRINTF_FUNC(...) printk(__VA_ARGS__)
 #include "lib_ret_err.h"
+#include "lib_trace.h"
+#include "lib_capture.h"
+#include "lib_uart_transport.h"
 #include <lib_formatter.hpp>
 #include <expected>
-#include <zephyr/drivers/uart.h>
+#ifndef NRF_UART_HOST
+#include "lib_uart_zephyr.h"
+#endif
+
+//compile-time printk debug level, see uart::DebugLevel
+// 0 - off
+// 1 - driver commands
+// 2 - + frame parsing
+// 3 - + every byte through uart::Channel
+#ifndef NRF_UART_DEBUG_LEVEL
+#define NRF_UART_DEBUG_LEVEL 0
+#endif
 
 namespace uart
 {
-    using duration_ms_t = int;
+    enum class DebugLevel: uint8_t
+    {
+        Off = 0,
+        Commands = 1,
+        Frames = 2,
+        Bytes = 3,
+    };
+    //debug output above this level is compiled out, the rest is always printed
+    static constexpr const DebugLevel kDebugLevel = DebugLevel(NRF_UART_DEBUG_LEVEL);
+
     static constexpr const duration_ms_t kForever = -2;
     static constexpr const duration_ms_t kDefault = -1;
     static constexpr const int ERR_OK = 0;
@@ -21,8 +44,6 @@ namespace uart
     public:
         using Ref = std::reference_wrapper<Channel>;
         using ExpectedResult = std::expected<Ref, Err>;
-        static constexpr const int kUARTAsyncBufSize = 8;
-        static constexpr const int32_t kUARTRxTimeoutBits = 9 * 2;
 
         template<typename V>
         using RetVal = RetValT<Ref, V>;
@@ -54,9 +75,14 @@ namespace uart
             duration_ms_t m_PrevWait;
         };
 
+#ifndef NRF_UART_HOST
         Channel(const struct device *pUART);
+#endif
+        Channel(Transport &t);
         ~Channel();
 
+        Transport& GetTransport() { return *m_pTransport; }
+
         ExpectedResult Configure();
 
         void SetDefaultWait(duration_ms_t w) { m_DefaultWait = w; }
@@ -78,33 +104,54 @@ namespace uart
 
         bool HasOverflow() const { return m_Overflow; }
 
+        //transport side, may be called from ISR context
+        void OnRx(const uint8_t *pData, int len);
+        void OnTxDone();
+        //bytes OnRx can take without overflowing the read buffer
+        int GetRxFree() const;
+
+        //cheap counters to compare transports/backends (rx events = OnRx calls)
+        struct Stats
+        {
+            uint32_t rx_bytes = 0;
+            uint32_t tx_bytes = 0;
+            uint32_t rx_events = 0;
+            uint32_t poll_spins = 0;
+            uint32_t overflows = 0;
+        };
+        Stats const& GetStats() const { return m_Stats; }
+        void ResetStats() { m_Stats = {}; }
+
+        //binary trace of channel/driver events; nullptr disables tracing
+        void SetTrace(trace::Ring *pTrace) { m_pTrace = pTrace; }
+        trace::Ring* GetTrace() const { return m_pTrace; }
+
+        template<class... T>
+        void Trace(trace::Event e, T const&... v) { if (m_pTrace) m_pTrace->Add(e, v...); }
+        void TraceBytes(trace::Event e, const uint8_t *pData, size_t len) { if (m_pTrace) m_pTrace->AddBytes(e, pData, len); }
+
+        //raw bytes of both directions as seen on the wire; nullptr disables capture
+        void SetCapture(capture::Recorder *pCapture) { m_pCapture = pCapture; }
+        capture::Recorder* GetCapture() const { return m_pCapture; }
+
         //using EventCallback = GenericCallback<void(uart_event_type_t)>;
         //void SetEventCallback(EventCallback cb) { m_EventCallback = std::move(cb); }
         //bool HasEventCallback() const { return (bool)m_EventCallback; }
 
+        //runtime switch for StopReading's buffer dump only; debug output is gated by kDebugLevel
         bool m_Dbg = false;
     private:
-        static void uart_async_callback(const struct device *dev, uart_event *evt, void *user_data);
-        int uart_send();
-        int uart_recv();
-
+        int WaitRx(duration_ms_t wait);
         size_t ReadInternal(uint8_t *pBuf, size_t len);
 
-        const struct device *m_pUART = nullptr;
+#ifndef NRF_UART_HOST
+        ZephyrUart m_ZephyrUart{nullptr};
+#endif
+        Transport *m_pTransport = nullptr;
         struct k_sem m_tx_sem;
         struct k_sem m_rx_sem;
-        struct k_sem m_rx_ctrl;
         duration_ms_t m_DefaultWait{0};
 
-        bool m_rx_state = false;
-
-        uint8_t m_UARTAsyncBufs[2][kUARTAsyncBufSize];
-        int m_UARTAsyncBufNext = -1;
-        int32_t m_UARTRxTimeoutUS = 200;
-        //receive buf
-        uint8_t *m_pRecvBuf = nullptr;
-        int m_RecvLen = 0;
-
         //target rcv
         uint8_t *m_pInternalRecvBuf = nullptr;
         int m_InternalRecvBufLen = 0;
@@ -112,13 +159,13 @@ namespace uart
         int m_InternalRecvBufNextRead = 0;
         bool m_Overflow = false;
 
-        //transmitt buf
-        const uint8_t *m_pSendBuf = nullptr;
-        int m_SendLen = 0;
-
         bool m_HasPeekByte = false;
         uint8_t m_PeekByte = 0;
 
+        trace::Ring *m_pTrace = nullptr;
+        capture::Recorder *m_pCapture = nullptr;
+        Stats m_Stats;
+
         //std::atomic<bool> m_DataReady={false};
         //EventCallback m_EventCallback;
 
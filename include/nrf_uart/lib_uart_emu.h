@@ -0,0 +1,122 @@
+#ifndef LIB_UART_EMU_H_
+#define LIB_UART_EMU_H_
+
+#include "lib_uart_memory.h"
+
+namespace uart
+{
+    namespace emu
+    {
+        //probabilities are in 1/1000 per queued frame/line
+        struct Faults
+        {
+            uint16_t corrupt = 0;   //flip one random byte
+            uint16_t truncate = 0;  //cut short (partial frame)
+            uint16_t garbage = 0;   //prepend 1..8 random bytes
+            uint16_t dropResp = 0;  //swallow a command response
+            duration_ms_t respDelay = 0; //command response latency
+            duration_ms_t respJitter = 0;//+[0..respJitter] on top of respDelay
+            duration_ms_t dataJitter = 0;//+[0..dataJitter] on each data frame
+        };
+
+        struct FaultStats
+        {
+            uint32_t corrupted = 0;
+            uint32_t truncated = 0;
+            uint32_t garbage = 0;
+            uint32_t queueFull = 0;//frames not queued because all slots were busy
+        };
+
+        /**********************************************************************/
+        /* Outbox                                                             */
+        /* Module-side output of an emulator: a FIFO of timestamped frames    */
+        /* fed into a MemoryTransport once due. Frame faults are applied on   */
+        /* Queue from a seeded xorshift PRNG, so runs are repeatable.         */
+        /* With the wire model on, delivery is limited to what a wire at the  */
+        /* transport's baudrate (10 bits per byte) could carry.               */
+        /**********************************************************************/
+        class Outbox
+        {
+        public:
+            static constexpr const size_t kMaxFrame = 64;
+            static constexpr const size_t kMaxQueued = 8;
+
+            Outbox(uint32_t seed): m_Rand(seed ? seed : 1) {}
+
+            uint32_t Rand();
+            bool Chance(uint16_t permille) { return permille && (Rand() % 1000) < permille; }
+            //[0..range]
+            duration_ms_t Jitter(duration_ms_t range) { return range > 0 ? duration_ms_t(Rand() % (range + 1)) : 0; }
+
+            void SetFaults(Faults const& f) { m_Faults = f; }
+            Faults const& GetFaults() const { return m_Faults; }
+            void SetWireModel(bool on) { m_WireModel = on; }
+
+            //applies frame faults and queues; false if no slot was free
+            bool Queue(int64_t due, const uint8_t *pData, size_t len);
+            void Deliver(MemoryTransport &t, int64_t now);
+            void Clear() { m_Count = 0; }
+
+            size_t size() const { return m_Count; }
+            bool full() const { return m_Count == kMaxQueued; }
+
+            FaultStats const& GetStats() const { return m_Stats; }
+            void ResetStats() { m_Stats = {}; }
+        private:
+            struct Slot
+            {
+                int64_t due = 0;
+                uint8_t len = 0;
+                uint8_t sent = 0;
+                uint8_t data[kMaxFrame];
+            };
+
+            Slot m_Slots[kMaxQueued];
+            size_t m_Head = 0;
+            size_t m_Count = 0;
+
+            Faults m_Faults;
+            FaultStats m_Stats;
+            uint32_t m_Rand;
+
+            int64_t m_LastDeliver = -1;
+            uint32_t m_WireCredit = 0;//bytes x 1000
+            bool m_WireModel = false;
+        };
+
+        /**********************************************************************/
+        /* Stream                                                             */
+        /* Fixed rate data frame cadence. Data frames use at most half of the */
+        /* outbox, the rest stays free for command responses. A stalled       */
+        /* reader doesn't get a burst of stale frames: falling behind by more */
+        /* than the outbox can hold restarts the cadence at now.              */
+        /**********************************************************************/
+        class Stream
+        {
+        public:
+            //0 - no streaming
+            void SetRate(uint16_t framesPerSecond) { m_PeriodMs = framesPerSecond ? 1000 / framesPerSecond : 0; }
+            bool Enabled() const { return m_PeriodMs != 0; }
+
+            //calls emit(due) for every frame due by now while active
+            template<class F>
+            void Run(Outbox &o, int64_t now, bool active, F &&emit)
+            {
+                if (!active || !m_PeriodMs)
+                {
+                    m_Next = -1;
+                    return;
+                }
+                if (m_Next < 0 || (now - m_Next) > int64_t(m_PeriodMs * Outbox::kMaxQueued))
+                    m_Next = now;
+                for(; m_Next <= now && o.size() < Outbox::kMaxQueued / 2; m_Next += m_PeriodMs)
+                    emit(m_Next + o.Jitter(o.GetFaults().dataJitter));
+            }
+        private:
+            duration_ms_t m_PeriodMs = 0;
+            int64_t m_Next = -1;
+        };
+    }
+}
+
+#endif
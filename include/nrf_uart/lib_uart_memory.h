@@ -0,0 +1,79 @@
+#ifndef LIB_UART_MEMORY_H_
+#define LIB_UART_MEMORY_H_
+
+#include "lib_uart_transport.h"
+#include <span>
+
+namespace uart
+{
+    /**********************************************************************/
+    /* MemoryTransport                                                    */
+    /* Polled in-memory byte pipe. Bytes queued with Feed are delivered    */
+    /* to the channel, bytes sent by the channel go to the Peer. A Peer    */
+    /* (emulator, replay) can produce time-dependent data in OnPoll.      */
+    /* Not thread safe: Feed, Poll and Send must run on one thread.       */
+    /**********************************************************************/
+    class MemoryTransport: public Transport
+    {
+    public:
+        struct Peer
+        {
+            virtual ~Peer() = default;
+            //bytes sent by the channel
+            virtual void OnTx(MemoryTransport &t, const uint8_t *pData, size_t len) = 0;
+            //called on every Poll before queued bytes are delivered
+            virtual void OnPoll(MemoryTransport &t) {}
+        };
+
+        MemoryTransport(std::span<uint8_t> rxStorage, uint32_t baudrate = 115200);
+
+        void SetPeer(Peer *pPeer) { m_pPeer = pPeer; }
+
+        //queues bytes for the channel; returns number of accepted bytes
+        size_t Feed(const uint8_t *pData, size_t len);
+        size_t Pending() const { return m_Used; }
+        void Clear() { m_Used = 0; m_Head = 0; }
+
+        //once set and the queue is empty, Poll reports -ENODATA instead of
+        //letting the channel wait for its timeout
+        void SetEndOfStream(bool eos) { m_EndOfStream = eos; }
+
+        //models a buffered (DMA) receiver like ZephyrUart's async backend: bytes reach the
+        //channel in whole bufSize pieces, a partly filled one only after nothing was fed for
+        //idleUS (see rx_idle_timeout_us). bufSize 0 (default) delivers everything at once.
+        void SetRxBuffering(size_t bufSize, int32_t idleUS) { m_RxBufSize = bufSize; m_RxIdleUS = idleUS; }
+
+        int Send(const uint8_t *pData, size_t len) override;
+        int StartRx() override { m_RxActive = true; return 0; }
+        int StopRx() override { m_RxActive = false; return 0; }
+        bool IsRxActive() const override { return m_RxActive; }
+
+        bool IsPolled() const override { return true; }
+        int Poll(duration_ms_t maxWait) override;
+
+        uint32_t GetBaudrate() const override { return m_Baudrate; }
+        int SetBaudrate(uint32_t baudrate) override { m_Baudrate = baudrate; return 0; }
+    private:
+        std::span<uint8_t> m_Storage;
+        size_t m_Head = 0;
+        size_t m_Used = 0;
+        Peer *m_pPeer = nullptr;
+        uint32_t m_Baudrate;
+        bool m_RxActive = false;
+        bool m_EndOfStream = false;
+        size_t m_RxBufSize = 0;
+        int32_t m_RxIdleUS = 0;
+        uint64_t m_LastFeedUs = 0;
+    };
+
+    template<size_t N>
+    class MemoryTransportStatic: public MemoryTransport
+    {
+    public:
+        MemoryTransportStatic(uint32_t baudrate = 115200): MemoryTransport(m_Buf, baudrate) {}
+    private:
+        uint8_t m_Buf[N];
+    };
+}
+
+#endif
@@ -45,6 +45,8 @@ namespace uart
             {
                 if (auto r = c.Read(buf, std::min(sizeof(buf), bytes)); !r)
                     return ExpectedResult(std::unexpected(r.error()));
+                else if (!r.value().v)//zero default wait: nothing arrived, don't spin
+                    return ExpectedResult(std::unexpected(::Err{"skip_bytes no data", ERR_OK}));
                 else
                     bytes -= r.value().v;
             }
@@ -0,0 +1,69 @@
+#ifndef LIB_UART_TRANSPORT_H_
+#define LIB_UART_TRANSPORT_H_
+
+#include <zephyr/kernel.h>
+#include <cstdint>
+#include <cstddef>
+#include <cerrno>
+
+namespace uart
+{
+    using duration_ms_t = int;
+    class Channel;
+
+    /**********************************************************************/
+    /* Transport                                                          */
+    /* Byte pipe underneath a Channel. Received bytes are handed to        */
+    /* Channel::OnRx, completed sends are reported with Channel::OnTxDone. */
+    /* Both may be called from ISR context.                               */
+    /**********************************************************************/
+    class Transport
+    {
+    public:
+        virtual ~Transport() = default;
+
+        //binds the transport to its channel; called from Channel::Configure
+        virtual int Configure(Channel &c) { m_pChannel = &c; return 0; }
+
+        //starts sending; the data must stay valid until Channel::OnTxDone
+        virtual int Send(const uint8_t *pData, size_t len) = 0;
+
+        virtual int StartRx() = 0;
+        virtual int StopRx() = 0;
+        virtual bool IsRxActive() const = 0;
+
+        //Transports without an own event source (polling, host) report true
+        //and deliver pending bytes from Poll. Poll may block for up to
+        //maxWait ms (<0 - no limit) and returns the number of delivered
+        //bytes, 0 if none arrived or <0 if no more data can ever arrive.
+        virtual bool IsPolled() const { return false; }
+        virtual int Poll(duration_ms_t maxWait) { return 0; }
+
+        virtual uint32_t GetBaudrate() const = 0;
+        virtual int SetBaudrate(uint32_t baudrate) { return -ENOTSUP; }
+
+    protected:
+        Channel *m_pChannel = nullptr;
+    };
+
+    //receive buffer of buffered (DMA) transports, ZephyrUart's async bounce buffers: bytes
+    //reach the channel in pieces this big, a partly filled one after the RX idle timeout
+    static constexpr const size_t kRxBounceSize = 8;
+    //RX idle gap: two characters (8N1) of silence, not shorter than the UARTE timer copes with
+    static constexpr const uint32_t kRxIdleGapBits = 10 * 2;
+    static constexpr const int32_t kRxIdleMinUS = 50;
+
+    //RX idle timeout of buffered (DMA) transports: once the line was quiet for gapBits bit
+    //times a partly filled buffer is handed over. A module sends a frame's bytes back to back
+    //and frames milliseconds apart, so a gap of a few characters is the end of a frame.
+    //Depends on the rate only, not on how long a reader is willing to wait.
+    constexpr int32_t rx_idle_timeout_us(uint32_t baudrate, uint32_t gapBits = kRxIdleGapBits, int32_t minUS = kRxIdleMinUS)
+    {
+        if (!baudrate)
+            return minUS;
+        int32_t us = int32_t((uint64_t(gapBits) * 1'000'000 + baudrate - 1) / baudrate);
+        return us > minUS ? us : minUS;
+    }
+}
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef LIB_UART_ZEPHYR_H_
+#define LIB_UART_ZEPHYR_H_
+
+#include "lib_uart_transport.h"
+#include <zephyr/drivers/uart.h>
+
+//UART driver API used by ZephyrUart:
+// 0 - async (DMA) API: uart_tx/uart_rx_enable
+// 1 - interrupt driven FIFO API: uart_irq_*/uart_fifo_*
+// 2 - busy polling: uart_poll_in/uart_poll_out
+#ifndef NRF_UART_BACKEND
+#if defined(CONFIG_UART_ASYNC_API)
+#define NRF_UART_BACKEND 0
+#elif defined(CONFIG_UART_INTERRUPT_DRIVEN)
+#define NRF_UART_BACKEND 1
+#else
+#define NRF_UART_BACKEND 2
+#endif
+#endif
+
+namespace uart
+{
+    enum class Backend: uint8_t
+    {
+        Async = 0,
+        Irq = 1,
+        Poll = 2,
+    };
+
+    /**********************************************************************/
+    /* ZephyrUart                                                         */
+    /**********************************************************************/
+    class ZephyrUart: public Transport
+    {
+    public:
+        static const constexpr Backend kBackend = Backend(NRF_UART_BACKEND);
+        static constexpr const int kUARTAsyncBufSize = int(kRxBounceSize);
+        //used when the driver can't report its rate; the slowest common one, so only ever too long
+        static constexpr const uint32_t kFallbackBaudrate = 9600;
+
+        ZephyrUart(const struct device *pUART): m_pUART(pUART) {}
+
+        int Configure(Channel &c) override;
+        int Send(const uint8_t *pData, size_t len) override;
+        int StartRx() override;
+        int StopRx() override;
+        bool IsRxActive() const override { return m_UARTAsyncBufNext != -1; }
+
+        bool IsPolled() const override { return kBackend == Backend::Poll; }
+        int Poll(duration_ms_t maxWait) override;
+
+        uint32_t GetBaudrate() const override;
+        //needs CONFIG_UART_USE_RUNTIME_CONFIGURE (-ENOTSUP otherwise); RX is restarted around
+        //uart_configure, with the RX timeout for the new rate
+        int SetBaudrate(uint32_t baudrate) override;
+
+        const struct device* GetDevice() const { return m_pUART; }
+        int32_t GetRxTimeoutUS() const { return m_UARTRxTimeoutUS; }
+    private:
+        static void uart_async_callback(const struct device *dev, uart_event *evt, void *user_data);
+        static void uart_irq_callback(const struct device *dev, void *user_data);
+        int uart_send();
+        int uart_recv();
+
+        const struct device *m_pUART = nullptr;
+        struct k_sem m_rx_ctrl;
+
+        bool m_rx_state = false;
+
+        uint8_t m_UARTAsyncBufs[2][kUARTAsyncBufSize];
+        int m_UARTAsyncBufNext = -1;
+        int32_t m_UARTRxTimeoutUS = 200;
+        //receive buf
+        uint8_t *m_pRecvBuf = nullptr;
+        int m_RecvLen = 0;
+
+        //transmitt buf
+        const uint8_t *m_pSendBuf = nullptr;
+        int m_SendLen = 0;
+        //Irq backend: set from Send until the last byte has left the shift register
+        bool m_TxPending = false;
+    };
+}
+
+#endif
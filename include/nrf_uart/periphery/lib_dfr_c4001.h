@@ -3,8 +3,14 @@
 
 #include <zephyr/drivers/uart.h>
 #include <span>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
 #include "../lib_uart.h"
 #include "../lib_uart_primitives.h"
+#include "../lib_cmd_stats.h"
+#include "../lib_latest.h"
+#include "../lib_frame_queue.h"
 #include <lib_type_traits.hpp>
 
 namespace dfr
@@ -84,10 +90,91 @@ namespace dfr
         }
     };
 
+    /**********************************************************************/
+    /* ASCII number readers used by the C4001 responses                   */
+    /**********************************************************************/
+    template<class T>
+    struct read_cfg_t
+    {
+        T min = 0;
+        T max = 0;
+    };
+    using read_float_cfg_t = read_cfg_t<float>;
+    using read_uint8_cfg_t = read_cfg_t<uint8_t>;
+
+    struct read_float_from_str_t
+    {
+        using functional_read_helper = void;
+        float &dstVar;
+        char until = ' ';
+        char dstStr[16];
+        bool consume_last = true;
+        read_float_cfg_t cfg{};
+
+        static constexpr size_t size() { return sizeof(dstStr); }
+        size_t rt_size() const { return sizeof(dstStr); }
+        auto run(uart::Channel &c) { 
+            using ExpectedResult = std::expected<uart::Channel::Ref, ::Err>;
+            //read_until_into copies raw bytes: keep the last one for the terminator
+            std::fill(std::begin(dstStr), std::end(dstStr), 0);
+            auto r = uart::primitives::read_until_into(c, until, (uint8_t*)dstStr, sizeof(dstStr) - 1, consume_last, {}); 
+            if (!r) return r;
+            char *pEnd = dstStr;
+            float v = strtof(dstStr, &pEnd);
+            if (pEnd == dstStr || !std::isfinite(v))
+            {
+                return ExpectedResult(std::unexpected(::Err{"failed to convert"}));
+            }
+            if (cfg.min != cfg.max)
+            {
+                if (v < cfg.min || v > cfg.max)
+                    return ExpectedResult(std::unexpected(::Err{"failed validation"}));
+            }
+            dstVar = v;
+            return r;
+        } 
+    };
+
+    struct read_uint8_from_str_t
+    {
+        using functional_read_helper = void;
+        uint8_t &dstVar;
+        char until = ' ';
+        char dstStr[16];
+        bool consume_last = true;
+        read_uint8_cfg_t cfg{};
+
+        static constexpr size_t size() { return sizeof(dstStr); }
+        size_t rt_size() const { return sizeof(dstStr); }
+        auto run(uart::Channel &c) { 
+            using ExpectedResult = std::expected<uart::Channel::Ref, ::Err>;
+            std::fill(std::begin(dstStr), std::end(dstStr), 0);
+            auto r = uart::primitives::read_until_into(c, until, (uint8_t*)dstStr, sizeof(dstStr) - 1, consume_last, {}); 
+            if (!r) return r;
+            char *pEnd = dstStr;
+            unsigned long v = strtoul(dstStr, &pEnd, 10);
+            if (pEnd == dstStr || v > 0xff)
+            {
+                return ExpectedResult(std::unexpected(::Err{"failed to convert"}));
+            }
+            if (cfg.min != cfg.max)
+            {
+                if (v < cfg.min || v > cfg.max)
+                    return ExpectedResult(std::unexpected(::Err{"failed validation"}));
+            }
+            dstVar = uint8_t(v);
+            return r;
+        } 
+    };
+
+    class C4001Emu;
+
     class C4001: public uart::Channel
     {
+        friend class C4001Emu;
         public:
             using duration_ms_t = uart::duration_ms_t;
+            using cmd_stats_t = uart::CmdStats<std::string_view, 24>;
             static const constexpr duration_ms_t kRestartTimeout{2000};
             static const constexpr duration_ms_t kDefaultWait{350};
 
@@ -118,11 +205,50 @@ namespace dfr
 
         public:
 
+            enum class AppMode: uint8_t
+            {
+                Presence = 0,
+                SpeedDistance = 1,
+            };
+
             /**********************************************************************/
             /* PresenceResult                                                     */
+            /* $DFHPD,<0|1>, , , *                                                */
+            /**********************************************************************/
+            struct PresenceResult
+            {
+                bool m_Presence = false;
+            };
+
+            /**********************************************************************/
+            /* TargetResult                                                       */
+            /* $DFDMD,<count>,<n/a>,<range m>,<speed m/s>,<energy>, , *           */
+            /**********************************************************************/
+            struct TargetResult
+            {
+                uint8_t m_Count = 0;
+                float m_Range = 0.f;//m
+                float m_Speed = 0.f;//m/s, sign gives the direction
+                float m_Energy = 0.f;
+            };
+
+            /**********************************************************************/
+            /* Frame                                                              */
+            /* Latest decoded line as published to other threads.                 */
             /**********************************************************************/
+            struct Frame
+            {
+                AppMode m_Mode = AppMode::Presence;//which of the two below came last
+                PresenceResult m_Presence;
+                TargetResult m_Target;
+            };
+            using frame_snapshot_t = uart::Latest<Frame>::Snapshot;
+            using frame_queue_t = uart::FrameQueue<frame_snapshot_t>;
 
+#ifndef NRF_UART_HOST
             C4001(const struct device *pUART);
+#endif
+            C4001(uart::Transport &t);
 
             ExpectedResult Init();
             ExpectedResult ReloadConfig();
@@ -140,6 +266,25 @@ namespace dfr
             auto GetClearLatency() const { return m_ClearLatency; }
             auto GetSensitivityHold() const { return m_SensitivityHold; }
             auto GetSensitivityTrig() const { return m_SensitivityTrigger; }
+
+            AppMode GetAppMode() const { return m_AppMode; }
+            //reading thread only (the one calling TryReadFrame)
+            PresenceResult GetPresence() const { return m_Presence; }
+            TargetResult GetTarget() const { return m_Target; }
+            //any thread: consistent copy of the latest line, never blocks the reading thread
+            frame_snapshot_t GetLatestFrame() const { return m_Latest.Read(); }
+            //every decoded line is also pushed here; nullptr (default) disables queueing
+            void SetFrameQueue(frame_queue_t *pQueue) { m_pQueue = pQueue; }
+
+            void StartContinuousReading();
+            void StopContinuousReading();
+            //read the next $DFHPD/$DFDMD line, skipping anything else
+            ExpectedResult TryReadFrame(int attempts = 3);
+            ExpectedResult TryReadSingleFrame(int attempts = 3);
+
+            //per command string round-trip statistics of SendCmd*
+            cmd_stats_t const& GetCmdStats() const { return m_CmdStats; }
+            void ResetCmdStats() { m_CmdStats.Reset(); }
         private:
 
             constexpr static const uint8_t kCmdSensorStop[] = "sensorStop";
@@ -217,6 +362,8 @@ namespace dfr
             ExpectedResult SendCmdNoResp(std::string_view cmd, ToSend&&...args) 
             { 
                 static_assert((Sendable<ToSend>::value && ... && true), "All arguments must be sendable");
+                auto probe = m_CmdStats.Start(cmd);
+                TraceBytes(uart::trace::Event::StrCmdSend, (const uint8_t*)cmd.data(), cmd.size());
                 Channel::ExpectedResult _r(std::ref(*this));
                 bool first = true;
                 auto send_one = [&]<class SendArg>(SendArg &&a)
@@ -234,6 +381,7 @@ namespace dfr
                 TRY_UART_COMM(_r, "SendArgs");
                 TRY_UART_COMM(Sendable<decltype("\r\n")>::send(*this, "\r\n"), "<endl>");
                 //TRY_UART_COMM(uart::primitives::drain(*this, {.maxWait = 50}), "SendCmdNoResp.drain");
+                probe.Success();
                 return std::ref(*this);
             }
 
@@ -242,6 +390,8 @@ namespace dfr
             ExpectedResult SendCmd(std::string_view cmd, ToSend&&...args) 
             { 
                 static_assert((Sendable<std::remove_cvref_t<ToSend>>::value && ... && true), "All arguments must be sendable");
+                auto probe = m_CmdStats.Start(cmd);
+                TraceBytes(uart::trace::Event::StrCmdSend, (const uint8_t*)cmd.data(), cmd.size());
                 Channel::ExpectedResult _r(std::ref(*this));
                 bool first = true;
                 auto send_one = [&]<class SendArg>(SendArg &&a)
@@ -264,8 +414,9 @@ namespace dfr
                 using namespace uart::primitives;
                 if (auto r = find_any_str({}, *this, "Done\r\n", "Error\r\n"); !r)
                     return std::unexpected(Err{r.error()});
-                else if (r->v != 0)//not 'Done', but 'Error'
+                else if (Trace(uart::trace::Event::StrCmdDone, uint8_t(r->v)); r->v != 0)//not 'Done', but 'Error'
                     return std::unexpected(Err{{"SendCmd Error resp"}});
+                probe.Success();
                 return std::ref(*this);
             }
 
@@ -273,6 +424,8 @@ namespace dfr
             ExpectedResult SendCmdWithParams(std::string_view cmd, std::tuple<ToSend...> tosend, std::tuple<ToRecv...> torecv, bool dbg = false) 
             { 
                 static_assert((Sendable<std::remove_cvref_t<ToSend>>::value && ... && true), "All arguments must be sendable");
+                auto probe = m_CmdStats.Start(cmd);
+                TraceBytes(uart::trace::Event::StrCmdSend, (const uint8_t*)cmd.data(), cmd.size());
                 Channel::ExpectedResult _r(std::ref(*this));
                 bool first = true;
                 auto send_one = [&]<class SendArg>(SendArg &&a)
@@ -299,20 +452,28 @@ namespace dfr
                     return uart::primitives::read_any(*this, std::get<idx>(torecv)...);
                 };
 
-                if (m_Dbg)
+                if constexpr (uart::kDebugLevel >= uart::DebugLevel::Commands)
+                {
                     printk("Receiving params\r\n");
+                }
                 TRY_UART_COMM(recv_tuple(std::make_index_sequence<sizeof...(ToRecv)>()), "SendCmdWithParams");
+                Trace(uart::trace::Event::StrCmdParams);
 
-                if (m_Dbg)
+                if constexpr (uart::kDebugLevel >= uart::DebugLevel::Commands)
+                {
                     printk("Received. Receiving Done or Error\r\n");
+                }
                 //wait for a final 'Done'
                 using namespace uart::primitives;
                 if (auto r = find_any_str({}, *this, "Done\r\n", "Error\r\n"); !r)
                     return std::unexpected(Err{r.error()});
-                else if (r->v != 0)//not 'Done', but 'Error'
+                else if (Trace(uart::trace::Event::StrCmdDone, uint8_t(r->v)); r->v != 0)//not 'Done', but 'Error'
                     return std::unexpected(Err{{"SendCmd Error"}});
-                if (m_Dbg)
+                if constexpr (uart::kDebugLevel >= uart::DebugLevel::Commands)
+                {
                     printk("Done\r\n");
+                }
+                probe.Success();
                 return std::ref(*this);
             }
 
@@ -331,6 +492,13 @@ namespace dfr
             }
 
             ExpectedResult ReadFrame();
+            //to GetLatestFrame readers and the frame queue
+            void Publish(Frame const& f)
+            {
+                auto published = m_Latest.Publish(f);
+                if (m_pQueue)
+                    m_pQueue->Push(published);
+            }
             
             //data
             //Version m_Version;
@@ -347,6 +515,8 @@ namespace dfr
 
             uint8_t m_recvBuf[128];
 
+            cmd_stats_t m_CmdStats;
+
             float m_Inhibit = 2;
             float m_MinRange = 1.6f;
             float m_MaxRange = 25.f;
@@ -357,6 +527,13 @@ namespace dfr
 
             float m_DetectLatency = 0.f;
             float m_ClearLatency = 0.f;
+
+            AppMode m_AppMode = AppMode::Presence;
+            PresenceResult m_Presence;
+            TargetResult m_Target;
+            uart::Latest<Frame> m_Latest;
+            frame_queue_t *m_pQueue = nullptr;
+            bool m_ContinuousRead = false;
         public:
             class Configurator
             {
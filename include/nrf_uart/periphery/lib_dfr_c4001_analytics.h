@@ -0,0 +1,124 @@
+#ifndef LIB_DFR_C4001_ANALYTICS_H_
+#define LIB_DFR_C4001_ANALYTICS_H_
+
+#include "lib_dfr_c4001.h"
+
+namespace dfr
+{
+    /**********************************************************************/
+    /* C4001Analytics                                                     */
+    /* Derived signals from SpeedDistance mode frames, reported as events */
+    /* instead of raw lines:                                              */
+    /*   Approach/Retreat/Stationary - the last directionFrames readings  */
+    /*                all agree on the sign of the speed (beyond          */
+    /*                speedCmS) and it differs from the last direction    */
+    /*   BandEnter/BandLeave - the range moved into/out of a configured   */
+    /*                band; BandLeave carries the dwell time              */
+    /*   Entry/Exit - a target session (first reading until it was gone   */
+    /*                for lostMs) ended having mostly approached/retreated */
+    /* Fixed memory: a kHistory reading ring and per band counters.       */
+    /**********************************************************************/
+    class C4001Analytics
+    {
+    public:
+        static constexpr const uint8_t kMaxBands = 4;
+        static constexpr const uint8_t kHistory = 8;
+        static constexpr const uint8_t kNoBand = 0xff;
+
+        struct Band
+        {
+            uint16_t minCm;
+            uint16_t maxCm;//exclusive
+        };
+
+        struct Config
+        {
+            uint16_t speedCmS = 10;//slower counts as stationary
+            uint8_t directionFrames = 3;//1..kHistory
+            uint16_t lostMs = 1000;
+            bool approachIsNegative = true;//sign of the reported speed when the target comes closer
+        };
+
+        enum class Direction: uint8_t { Unknown, Stationary, Approach, Retreat };
+        enum class Kind: uint8_t { Approach, Retreat, Stationary, BandEnter, BandLeave, Entry, Exit };
+
+        struct Event
+        {
+            int64_t uptimeMs;
+            Kind kind;
+            uint8_t band;//Band* events, kNoBand otherwise
+            uint16_t rangeCm;
+            int16_t speedCmS;//positive = approaching
+            uint32_t dwellMs;//BandLeave: time in the band, Entry/Exit: session length
+        };
+        using event_queue_t = uart::FrameQueue<Event>;
+
+        C4001Analytics() = default;
+        C4001Analytics(Config const& cfg): m_Cfg(cfg) {}
+
+        void SetConfig(Config const& cfg) { m_Cfg = cfg; }
+        Config const& GetConfig() const { return m_Cfg; }
+
+        //false if full or empty
+        bool AddBand(Band const& b);
+        void ClearBands() { m_BandCount = 0; m_Band = kNoBand; }
+
+        //events are also pushed here; nullptr (default) disables it
+        void SetEventQueue(event_queue_t *pQueue) { m_pQueue = pQueue; }
+
+        //feeding thread; returns the number of events this reading produced
+        uint8_t Add(C4001::TargetResult const& t, int64_t nowMs);
+        //skips Presence mode frames
+        uint8_t Add(C4001::frame_snapshot_t const& f);
+        //feeding thread: the events of the last Add
+        std::span<const Event> GetLastEvents() const { return {m_Events, m_EventCount}; }
+
+        Direction GetDirection() const { return m_Dir; }
+        uint8_t GetBand() const { return m_Band; }
+        //total time spent in a band, the current stay included
+        uint32_t GetDwellMs(uint8_t band, int64_t nowMs) const;
+        uint32_t GetEntries() const { return m_Entries; }
+        uint32_t GetExits() const { return m_Exits; }
+        void ResetCounters();
+    private:
+        struct Sample
+        {
+            uint16_t rangeCm;
+            int16_t speedCmS;//positive = approaching
+        };
+
+        void Emit(Kind k, int64_t nowMs, uint8_t band, Sample const& s, uint32_t dwellMs = 0);
+        void EnterBand(uint8_t band, int64_t nowMs, Sample const& s);
+        void UpdateDirection(int64_t nowMs, Sample const& s);
+        void EndSession(int64_t nowMs);
+
+        Config m_Cfg;
+        Band m_Bands[kMaxBands];
+        uint8_t m_BandCount = 0;
+        uint64_t m_DwellMs[kMaxBands] = {};
+
+        Sample m_History[kHistory];
+        uint8_t m_HistoryHead = 0;
+        uint8_t m_HistoryCount = 0;
+
+        bool m_InSession = false;
+        int64_t m_SessionStartMs = 0;
+        int64_t m_LastSeenMs = 0;
+        uint32_t m_ApproachFrames = 0;
+        uint32_t m_RetreatFrames = 0;
+        Direction m_Dir = Direction::Unknown;
+        uint8_t m_Band = kNoBand;
+        int64_t m_BandSinceMs = 0;
+        Sample m_Last{};
+
+        uint32_t m_Entries = 0;
+        uint32_t m_Exits = 0;
+
+        //one reading yields at most: direction + band leave + band enter (+ entry/exit on loss)
+        Event m_Events[4];
+        uint8_t m_EventCount = 0;
+        event_queue_t *m_pQueue = nullptr;
+    };
+}
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef LIB_DFR_C4001_EMU_H_
+#define LIB_DFR_C4001_EMU_H_
+
+#include "../lib_uart_emu.h"
+#include "lib_dfr_c4001.h"
+#include <string_view>
+
+namespace dfr
+{
+    /**********************************************************************/
+    /* C4001Emu                                                           */
+    /* Software C4001 behind a uart::MemoryTransport. Implements the      */
+    /* ASCII shell the driver uses: every command line is echoed, getters */
+    /* answer with 'Response ...', commands end with 'Done' or 'Error'.   */
+    /* Settings can only change while the sensor is stopped.              */
+    /* While started, $DFHPD (presence app) or $DFDMD (speed/distance     */
+    /* app) lines are streamed at a fixed rate; they land between         */
+    /* response lines, never inside one. Latency and line noise come from */
+    /* uart::emu::Outbox.                                                 */
+    /* Values are kept in thousandths so no float formatting is needed.   */
+    /**********************************************************************/
+    class C4001Emu: public uart::MemoryTransport::Peer
+    {
+    public:
+        using Faults = uart::emu::Faults;
+        using AppMode = C4001::AppMode;
+
+        struct Stats
+        {
+            uint32_t commands = 0;
+            uint32_t errors = 0;      //commands answered with 'Error'
+            uint32_t dataLines = 0;
+            uint32_t droppedResp = 0;
+            uint32_t rxOverflow = 0;  //command lines longer than the line buffer
+        };
+
+        C4001Emu(uint32_t seed = 1);
+
+        //attaches the emulator as the transport's peer
+        void Attach(uart::MemoryTransport &t) { t.SetPeer(this); }
+
+        //0 - no streaming
+        void SetDataRate(uint16_t linesPerSecond) { m_Stream.SetRate(linesPerSecond); }
+        void SetWireModel(bool on) { m_Out.SetWireModel(on); }
+        void SetFaults(Faults const& f) { m_Out.SetFaults(f); }
+        //time the module stays silent after resetSystem/setRunApp
+        void SetRestartTime(uart::duration_ms_t t) { m_RestartTime = t; }
+
+        void SetPresence(bool p) { m_Presence = p; }
+        void SetTarget(C4001::TargetResult const& t);
+
+        bool IsRunning() const { return m_Running; }
+        AppMode GetAppMode() const { return m_AppMode; }
+        Stats const& GetStats() const { return m_Stats; }
+        uart::emu::FaultStats const& GetFaultStats() const { return m_Out.GetStats(); }
+        void ResetStats() { m_Stats = {}; m_Out.ResetStats(); }
+
+        void OnTx(uart::MemoryTransport &t, const uint8_t *pData, size_t len) override;
+        void OnPoll(uart::MemoryTransport &t) override;
+    private:
+        static constexpr const size_t kMaxArgs = 2;
+
+        void ResetConfiguration();
+        void HandleLine(std::string_view line);
+        //queues one response line, "\r\n" is appended
+        void Respond(std::string_view line);
+        void Done(bool ok);
+        void QueueDataLine(int64_t due);
+
+        uart::emu::Outbox m_Out;
+        uart::emu::Stream m_Stream;
+
+        //command line being received
+        char m_Line[uart::emu::Outbox::kMaxFrame];
+        size_t m_LineLen = 0;
+        bool m_LineOverflow = false;
+
+        //module state, x1000
+        int32_t m_RangeFrom;
+        int32_t m_RangeTo;
+        int32_t m_TrigRange;
+        int32_t m_Inhibit;
+        int32_t m_DetectLatency;
+        int32_t m_ClearLatency;
+        uint8_t m_SensitivityHold;
+        uint8_t m_SensitivityTrig;
+        AppMode m_AppMode = AppMode::Presence;
+        bool m_Running = true;
+        std::string_view m_HWVersion = "C4001_EMU_HW_1.0";
+        std::string_view m_SWVersion = "C4001_EMU_SW_1.0";
+
+        //streamed data, x1000
+        bool m_Presence = false;
+        uint8_t m_TargetCount = 0;
+        int32_t m_TargetRange = 0;
+        int32_t m_TargetSpeed = 0;
+        int32_t m_TargetEnergy = 0;
+
+        uart::duration_ms_t m_RestartTime = 500;
+        int64_t m_SilentUntil = 0;
+        int64_t m_Now = 0;
+        //response of the command being handled
+        int64_t m_RespDue = 0;
+        bool m_DropResp = false;
+        Stats m_Stats;
+    };
+}
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef LIB_DFR_C4001_TRACK_H_
+#define LIB_DFR_C4001_TRACK_H_
+
+#include "lib_dfr_c4001.h"
+#include "../lib_track_filters.h"
+
+namespace dfr
+{
+    /**********************************************************************/
+    /* C4001Track                                                         */
+    /* Smoothed range (cm) and velocity of the SpeedDistance mode target  */
+    /* with a filter from lib_track_filters.h, e.g.                       */
+    /*   C4001Track<uart::filters::AlphaBeta<64, 8>> track;               */
+    /* Presence mode frames are ignored.                                  */
+    /**********************************************************************/
+    template<class F>
+    class C4001Track
+    {
+    public:
+        using Estimate = uart::filters::Estimate;
+
+        C4001Track(uint32_t maxGapMs = 2000): m_Range(maxGapMs) {}
+
+        void Add(C4001::TargetResult const& t, int64_t nowMs)
+        {
+            m_Range.Add(t.m_Count > 0, int32_t(std::lround(t.m_Range * 100.f)), nowMs);
+        }
+        void Add(C4001::frame_snapshot_t const& f)
+        {
+            if (f.value.m_Mode == C4001::AppMode::SpeedDistance)
+                Add(f.value.m_Target, f.uptimeMs);
+        }
+
+        bool Valid() const { return m_Range.Valid(); }
+        Estimate const& Get() const { return m_Range.Get(); }
+    private:
+        uart::filters::Track<F> m_Range;
+    };
+}
+
+#endif
@@ -5,17 +5,22 @@
 #include <span>
 #include "../lib_uart.h"
 #include "../lib_uart_primitives.h"
+#include "../lib_cmd_stats.h"
+#include "../lib_latest.h"
+#include "../lib_frame_queue.h"
 #include <lib_type_traits.hpp>
 #include <lib_misc_helpers.hpp>
 
 namespace hlk{
+    class LD2412Emu;
+    class LD2412EnergyStats;
+
     class LD2412: public uart::Channel
     {
+        friend class LD2412Emu;
     public:
         static const constexpr uart::duration_ms_t kRestartTimeout{2000};
         static const constexpr uart::duration_ms_t kDefaultWait{350};
-        static const constexpr bool kDebugFrame = false;
-        static const constexpr bool kDebugCommands = false;
         static const constexpr uint8_t kMinGate = 0;
         static const constexpr uint8_t kMaxGate = 13;
         static const constexpr uint8_t kGateCount = 14;
@@ -24,9 +29,11 @@ namespace hlk{
         {
             uint8_t min;
             uint8_t max;
-            uint8_t avg;
+            uint8_t avg;//rounded mean
+            uint16_t var;//population variance, energy units squared (rounded)
         };
         using energy_stat_array_t = std::array<energy_stat_t, kGateCount>;
+        using cmd_stats_t = uart::CmdStats<uint16_t, 24>;
 
         enum class ErrorCode: uint8_t
         {
@@ -59,6 +66,10 @@ namespace hlk{
             BTFailed,
             FactoryResetFailed,
             WrongState,
+            Calibration_NotEnoughData,
+            BaudRate_NotSupported,//the transport can't change to the rate; the module was not touched
+            BaudRate_Failed,//no link at the new rate; back at the previous (or the default) one
+            BaudRate_LinkLost,//no link at any rate tried
         };
         static const char* err_to_str(ErrorCode e);
 
@@ -93,6 +104,22 @@ namespace hlk{
             DetectWhenBiggerThan = 2,
         };
 
+        //SetBaudRate parameter; the module applies it on restart and keeps it across power cycles
+        enum class BaudRate: uint16_t
+        {
+            _9600 = 0x0001,
+            _19200 = 0x0002,
+            _38400 = 0x0003,
+            _57600 = 0x0004,
+            _115200 = 0x0005,
+            _230400 = 0x0006,
+            _256000 = 0x0007,//factory default
+            _460800 = 0x0008,
+        };
+        static constexpr const uint32_t kDefaultBaudrate = 256000;
+        //0 for an unknown value
+        static uint32_t to_baudrate(BaudRate r);
+
         enum class Drain
         {
             No,
@@ -180,6 +207,52 @@ namespace hlk{
         };
 #pragma pack(pop)
 
+        /**********************************************************************/
+        /* Frame                                                              */
+        /* Latest decoded data frame as published to other threads.           */
+        /**********************************************************************/
+        struct Frame
+        {
+            SystemMode m_Mode = SystemMode::Simple;
+            PresenceResult m_Presence;
+            Engeneering m_Engeneering{};//from the last Energy mode frame
+        };
+        using frame_snapshot_t = uart::Latest<Frame>::Snapshot;
+        using frame_queue_t = uart::FrameQueue<frame_snapshot_t>;
+
+        /**********************************************************************/
+        /* Calibration                                                        */
+        /* Thresholds measured from an empty room: the sensor is switched to  */
+        /* Energy mode for m_Duration, per gate noise is estimated as         */
+        /* max(observed max, mean + m_Sigmas * stddev) and the threshold is   */
+        /* that plus m_Margin, clamped to [m_MinThreshold, m_MaxThreshold].   */
+        /* Thresholds and the previous mode go back in one ConfigBlock.       */
+        /**********************************************************************/
+        struct CalibrationConfig
+        {
+            uart::duration_ms_t m_Duration = 10000;//the room must stay empty for this long
+            uint16_t m_MaxFrames = 0;//stop as soon as this many frames were collected, 0 - run for m_Duration
+            uint16_t m_MinFrames = 20;//fewer frames fail the calibration
+            uint8_t m_Margin = 10;
+            uint8_t m_Sigmas = 3;
+            uint8_t m_MinThreshold = 10;
+            uint8_t m_MaxThreshold = 100;
+            bool m_Apply = true;//false - measure and report only
+        };
+        struct CalibrationReport
+        {
+            uint16_t m_Frames = 0;//Energy mode frames, the only ones in the statistics
+            uint16_t m_OtherModeFrames = 0;//read fine, but not Energy mode: skipped
+            uint16_t m_ReadFailures = 0;
+            energy_stat_array_t m_Move{};
+            energy_stat_array_t m_Still{};
+            gate_array_t m_MoveThresholds{};//chosen
+            gate_array_t m_StillThresholds{};
+            gate_array_t m_PrevMoveThresholds{};//before the calibration
+            gate_array_t m_PrevStillThresholds{};
+            bool m_Applied = false;
+        };
+
 
         /**********************************************************************/
         /* ConfigBlock                                                        */
@@ -247,7 +320,10 @@ namespace hlk{
             };
         };
 
+#ifndef NRF_UART_HOST
         LD2412(const struct device *pUART);
+#endif
+        LD2412(uart::Transport &t);
 
         ExpectedResult Init();
 
@@ -296,16 +372,43 @@ namespace hlk{
         ExpectedResult Restart();
         ExpectedResult FactoryReset();
 
+        //moves the module and the transport to another rate. The transport is tried at the new
+        //rate first (BaudRate_NotSupported, nothing sent to the module); then the module gets the
+        //new rate and a restart, the transport follows and the link is checked with a version
+        //query. If that fails the transport goes back to the previous rate, then to
+        //kDefaultBaudrate, and the first one that answers stays (BaudRate_Failed). If none does
+        //the module's rate is unknown (BaudRate_LinkLost): the transport is left at the new rate,
+        //which the module acknowledged and stores, so it answers there after its next restart at
+        //the latest. Blocks for the restart (~1s); not while continuous reading (WrongState).
+        ExpectedResult SetBaudRate(BaudRate r);
+
+        //reading thread only (the one calling TryReadFrame)
         PresenceResult GetPresence() const { return m_Presence; }
         const Engeneering& GetEngeneeringData() const { return m_Engeneering; }
+        //any thread: consistent copy of the latest frame, never blocks the reading thread
+        frame_snapshot_t GetLatestFrame() const { return m_Latest.Read(); }
+        //every decoded frame is also pushed here; nullptr (default) disables queueing
+        void SetFrameQueue(frame_queue_t *pQueue) { m_pQueue = pQueue; }
+        //Energy mode frames are also fed here; nullptr (default) disables it
+        void SetEnergyStats(LD2412EnergyStats *pStats) { m_pEnergyStats = pStats; }
 
         void StartContinuousReading();
         void StopContinuousReading();
+        bool IsContinuousReading() const { return m_ContinuousRead; }
+        //mode-only ConfigBlock; continuous reading is paused for the commands and resumed,
+        //so the reading thread only misses the frames sent while they run
+        ExpectedResult SwitchSystemMode(SystemMode mode);
         ExpectedResult TryReadFrame(int attempts = 3, Drain drain = Drain::No);
         ExpectedResult TryReadSingleFrame(int attempts = 3, Drain drain = Drain::No);
 
         ExpectedResult RunDynamicBackgroundAnalysis();
         bool IsDynamicBackgroundAnalysisRunning();
+        //blocking for cfg.m_Duration; not while continuous reading (WrongState)
+        ExpectedResult CalibrateThresholds(CalibrationConfig const& cfg, CalibrationReport *pReport = nullptr);
+
+        //per command id (see Cmd) round-trip statistics of SendCommand
+        cmd_stats_t const& GetCmdStats() const { return m_CmdStats; }
+        void ResetCmdStats() { m_CmdStats.Reset(); }
     private:
         static int GetDistanceResFactor(DistanceRes r)
         { 
@@ -342,6 +445,7 @@ namespace hlk{
             SetLightSensitivity = 0x000c,
             GetLightSensitivity = 0x001c,
 
+            SetBaudRate = 0x00a1,
             FactoryReset = 0x00a2,
             Restart = 0x00a3,
 
@@ -381,6 +485,10 @@ namespace hlk{
         constexpr static uint8_t kFrameFooter[] = {0x04, 0x03, 0x02, 0x01};
         constexpr static uint8_t kDataFrameHeader[] = {0xf4, 0xf3, 0xf2, 0xf1};
         constexpr static uint8_t kDataFrameFooter[] = {0xf8, 0xf7, 0xf6, 0xf5};
+        //no ACK comes close; anything longer is line noise and not worth skipping byte by byte
+        constexpr static uint16_t kMaxAckLen = 64;
+        //data report: mode, 0xaa, payload, 0x55, check
+        constexpr static uint16_t kReportOverhead = 4;
 
         template<class E>
         static ExpectedResult to_result(E &&e, const char* pLocation, ErrorCode ec);
@@ -408,6 +516,8 @@ namespace hlk{
         ExpectedGenericCmdResult SetDistanceResInternal(DistanceRes r);
 
         ExpectedResult QueryDynamicBackgroundAnalysisRunState();
+        //after a restart: waits for the module, reads the version, restores m_Mode
+        ExpectedResult VerifyLink(const char *pLocation, ErrorCode ec);
 
         ExpectedResult ReadFrame();
 
@@ -419,6 +529,9 @@ namespace hlk{
         //the data will be read into as is
         PresenceResult m_Presence;
         Engeneering m_Engeneering;
+        uart::Latest<Frame> m_Latest;
+        frame_queue_t *m_pQueue = nullptr;
+        LD2412EnergyStats *m_pEnergyStats = nullptr;
 
         std::array<uint8_t, 6> m_BluetoothMAC = {0};
         bool m_LastBluetoothState = false;
@@ -428,6 +541,8 @@ namespace hlk{
             uint8_t m_FixedBuf[5] = {0, 0, 0, 0, 0};
         }m_DistanceResolution;
 
+        cmd_stats_t m_CmdStats;
+
         bool m_DynamicBackgroundAnalysis = false;
         bool m_ContinuousRead = false;
 
@@ -444,6 +559,7 @@ namespace hlk{
             bool &m_Dbg;
             bool m_PrevDbg;
         };
+        //kept for DbgNow scopes; debug output itself is gated by uart::kDebugLevel
         bool m_dbg = false;
     };
 }
@@ -0,0 +1,86 @@
+#ifndef LIB_LD2412_BACKGROUND_H_
+#define LIB_LD2412_BACKGROUND_H_
+
+#include "lib_ld2412.hpp"
+
+namespace hlk{
+    /**********************************************************************/
+    /* LD2412Background                                                   */
+    /* Continuously adapting per-gate noise floor, the on-line            */
+    /* counterpart of RunDynamicBackgroundAnalysis. Per gate and energy   */
+    /* kind an exponential moving average of the energy (baseline) and of */
+    /* its absolute deviation is kept in 8.8 fixed point; the effective   */
+    /* threshold is baseline + max(margin, devFactor * deviation).        */
+    /* Gates above their threshold are frozen so a present target is not */
+    /* learned as background (all gates with freezeAll). A detection that */
+    /* lasts longer than maxFreezeFrames is absorbed, which lets moved    */
+    /* furniture fade out. The first warmupFrames assume an empty room    */
+    /* and converge faster. Fixed integer cost per frame, no divisions.   */
+    /**********************************************************************/
+    class LD2412Background
+    {
+    public:
+        using Engeneering = LD2412::Engeneering;
+        using gate_array_t = LD2412::gate_array_t;
+
+        struct Config
+        {
+            uint8_t shift = 6;//alpha = 2^-shift per frame
+            uint8_t warmupShift = 2;
+            uint16_t warmupFrames = 32;
+            uint8_t margin = 8;
+            uint8_t devFactor = 4;
+            uint8_t maxThreshold = 100;
+            uint16_t maxFreezeFrames = 0;//0 - frozen for as long as the detection lasts
+            bool freezeAll = false;
+        };
+
+        struct Detection
+        {
+            uint16_t moveGates = 0;//bit g - gate g above its effective threshold
+            uint16_t stillGates = 0;
+        };
+
+        LD2412Background() = default;
+        LD2412Background(Config const& cfg): m_Cfg(cfg) {}
+
+        //restarts learning (warm-up included)
+        void SetConfig(Config const& cfg) { m_Cfg = cfg; Reset(); }
+        Config const& GetConfig() const { return m_Cfg; }
+        void Reset() { m_Frames = 0; }
+
+        //feeding thread: compares against the current thresholds, then adapts
+        Detection Add(Engeneering const& e);
+
+        bool IsWarmedUp() const { return m_Frames >= m_Cfg.warmupFrames; }
+        uint32_t GetFrames() const { return m_Frames; }
+
+        //rounded baseline / effective threshold per gate
+        gate_array_t GetMoveBaseline() const { return Baseline(m_Move); }
+        gate_array_t GetStillBaseline() const { return Baseline(m_Still); }
+        gate_array_t const& GetMoveThresholds() const { return m_Move.thr; }
+        gate_array_t const& GetStillThresholds() const { return m_Still.thr; }
+    private:
+        struct Model
+        {
+            std::array<uint16_t, LD2412::kGateCount> base;//8.8
+            std::array<uint16_t, LD2412::kGateCount> dev;//8.8
+            std::array<uint16_t, LD2412::kGateCount> frozen;//consecutive frames above the threshold
+            gate_array_t thr;
+        };
+
+        static gate_array_t Baseline(Model const& m);
+        uint16_t Detect(Model const& m, gate_array_t const& v) const;
+        //counts detection lengths; returns the gates to keep frozen
+        uint16_t Freeze(Model &m, uint16_t detected) const;
+        void Learn(Model &m, gate_array_t const& v, uint16_t skip) const;
+        void Init(Model &m, gate_array_t const& v);
+
+        Config m_Cfg;
+        uint32_t m_Frames = 0;
+        Model m_Move;
+        Model m_Still;
+    };
+}
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef LIB_LD2412_CHANGE_H_
+#define LIB_LD2412_CHANGE_H_
+
+#include "lib_ld2412.hpp"
+
+namespace hlk{
+    /**********************************************************************/
+    /* LD2412ChangeFilter                                                 */
+    /* Turns the 10-20 reports per second into an event stream that only  */
+    /* carries news:                                                      */
+    /*   Transition - TargetState changed; emitted on the frame that shows */
+    /*                it, unless the previous transition is younger than  */
+    /*                holdMs (flapping): then it is emitted once the hold */
+    /*                expires and only if the new state is still there    */
+    /*   Change     - same state, but distance/energy of the reported     */
+    /*                target(s) moved by the hysteresis since the last    */
+    /*                event; at most one per minIntervalMs                */
+    /*   Heartbeat  - nothing was emitted for heartbeatMs                 */
+    /* Hysteresis is against the last emitted values, so slow drift is    */
+    /* reported once it adds up. Feed it from the reading thread.         */
+    /**********************************************************************/
+    class LD2412ChangeFilter
+    {
+    public:
+        using PresenceResult = LD2412::PresenceResult;
+        using TargetState = LD2412::TargetState;
+
+        struct Config
+        {
+            uint16_t distanceCm = 30;//0 - distance changes are not reported
+            uint8_t energy = 20;//0 - energy changes are not reported
+            uint16_t holdMs = 500;
+            uint16_t minIntervalMs = 1000;
+            uint32_t heartbeatMs = 60000;//0 - no heartbeat
+        };
+
+        enum class Reason: uint8_t { Transition, Change, Heartbeat };
+
+        struct Event
+        {
+            int64_t uptimeMs;
+            Reason reason;
+            PresenceResult presence;
+        };
+        using event_queue_t = uart::FrameQueue<Event>;
+
+        struct Stats
+        {
+            uint32_t frames = 0;
+            uint32_t events = 0;
+            uint32_t suppressedTransitions = 0;//flaps that ended within holdMs
+        };
+
+        LD2412ChangeFilter() = default;
+        LD2412ChangeFilter(Config const& cfg): m_Cfg(cfg) {}
+
+        void SetConfig(Config const& cfg) { m_Cfg = cfg; }
+        Config const& GetConfig() const { return m_Cfg; }
+        //the next frame is emitted as a Transition
+        void Reset() { m_HasLast = false; m_Pending = false; }
+
+        //events are also pushed here; nullptr (default) disables it
+        void SetEventQueue(event_queue_t *pQueue) { m_pQueue = pQueue; }
+
+        //true if the frame produced an event (in ev)
+        bool Add(PresenceResult const& p, int64_t nowMs, Event &ev);
+        bool Add(LD2412::frame_snapshot_t const& f, Event &ev) { return Add(f.value.m_Presence, f.uptimeMs, ev); }
+
+        //the state the consumer was last told about
+        PresenceResult const& GetLastEmitted() const { return m_Last; }
+        Stats const& GetStats() const { return m_Stats; }
+    private:
+        bool Changed(PresenceResult const& p) const;
+        bool Emit(Reason r, PresenceResult const& p, int64_t nowMs, Event &ev);
+
+        Config m_Cfg;
+        PresenceResult m_Last;
+        bool m_HasLast = false;
+        int64_t m_LastEventMs = 0;
+        int64_t m_LastTransitionMs = 0;
+        int64_t m_LastChangeMs = 0;
+        bool m_Pending = false;//a transition is waiting for the hold to expire
+        Stats m_Stats;
+        event_queue_t *m_pQueue = nullptr;
+    };
+}
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef LIB_LD2412_EMU_H_
+#define LIB_LD2412_EMU_H_
+
+#include "../lib_uart_emu.h"
+#include "lib_ld2412.hpp"
+
+namespace hlk{
+    /**********************************************************************/
+    /* LD2412Emu                                                          */
+    /* Software LD2412 behind a uart::MemoryTransport. Answers the binary  */
+    /* command protocol (every LD2412::Cmd) and, outside command mode,    */
+    /* streams Simple or Energy data frames at a fixed rate. Faults       */
+    /* (corruption, truncated frames, garbage, lost ACKs, latency) are    */
+    /* injected by uart::emu::Outbox.                                     */
+    /* Runs entirely from the transport's OnTx/OnPoll hooks: no threads.  */
+    /**********************************************************************/
+    class LD2412Emu: public uart::MemoryTransport::Peer
+    {
+    public:
+        using Cmd = LD2412::Cmd;
+        using SystemMode = LD2412::SystemMode;
+        using PresenceResult = LD2412::PresenceResult;
+        using Engeneering = LD2412::Engeneering;
+        using Faults = uart::emu::Faults;
+
+        static constexpr const uint16_t kProtocolVersion = 1;
+        static constexpr const uint16_t kBufferSize = 64;
+
+        struct Stats
+        {
+            uint32_t commands = 0;
+            uint32_t acks = 0;
+            uint32_t dataFrames = 0;
+            uint32_t droppedAcks = 0;
+            uint32_t rxMalformed = 0; //bytes discarded while looking for a command header
+        };
+
+        LD2412Emu(uint32_t seed = 1);
+
+        //attaches the emulator as the transport's peer
+        void Attach(uart::MemoryTransport &t) { t.SetPeer(this); }
+
+        //0 - no streaming
+        void SetDataRate(uint16_t framesPerSecond) { m_Stream.SetRate(framesPerSecond); }
+        //limit delivery to what a wire at the transport's baudrate could carry
+        void SetWireModel(bool on) { m_Out.SetWireModel(on); }
+        void SetFaults(Faults const& f) { m_Out.SetFaults(f); }
+        //time the module stays silent after Restart/FactoryReset
+        void SetRestartTime(uart::duration_ms_t t) { m_RestartTime = t; }
+        //time RunDynamicBackgroundAnalysis reports as running
+        void SetBackgroundAnalysisTime(uart::duration_ms_t t) { m_BackgroundAnalysisTime = t; }
+
+        void SetPresence(PresenceResult const& p) { m_Presence = p; }
+        void SetEngeneering(Engeneering const& e) { m_Engeneering = e; }
+        void SetVersion(LD2412::Version const& v) { m_Version = v; }
+        //the module's line rate; while it differs from the transport's, both directions are
+        //garbage to the other side. 0 (default) - always the transport's rate
+        void SetBaudrate(uint32_t baudrate) { m_Baudrate = baudrate; }
+        uint32_t GetBaudrate() const { return m_Baudrate; }
+
+        bool IsInCommandMode() const { return m_CmdMode; }
+        SystemMode GetSystemMode() const { return m_Mode; }
+        Stats const& GetStats() const { return m_Stats; }
+        uart::emu::FaultStats const& GetFaultStats() const { return m_Out.GetStats(); }
+        void ResetStats() { m_Stats = {}; m_Out.ResetStats(); }
+
+        void OnTx(uart::MemoryTransport &t, const uint8_t *pData, size_t len) override;
+        void OnPoll(uart::MemoryTransport &t) override;
+    private:
+        void ResetConfiguration();
+        void HandleCommand(Cmd c, const uint8_t *pParams, size_t len);
+        void Ack(Cmd c, uint16_t status, const void *pPayload = nullptr, size_t len = 0);
+        void QueueDataFrame(int64_t due);
+        bool LineMatches(uart::MemoryTransport const& t) const { return !m_Baudrate || m_Baudrate == t.GetBaudrate(); }
+
+        //command parser (bytes sent by the driver)
+        uint8_t m_CmdBuf[uart::emu::Outbox::kMaxFrame];
+        size_t m_CmdLen = 0;
+
+        uart::emu::Outbox m_Out;
+        uart::emu::Stream m_Stream;
+
+        //module state
+        LD2412::Configuration m_Configuration;
+        LD2412::DistanceResBuf m_DistanceResolution;
+        LD2412::Version m_Version{.m_Minor = 0x01, .m_Major = 0x01, .m_Misc = 0x24120001};
+        std::array<uint8_t, 6> m_MAC = {0x8c, 0xaa, 0xb5, 0x24, 0x12, 0x01};
+        SystemMode m_Mode = SystemMode::Simple;
+        PresenceResult m_Presence;
+        Engeneering m_Engeneering{};
+        bool m_CmdMode = false;
+        bool m_Bluetooth = true;
+        int64_t m_BackgroundAnalysisEnd = 0;
+        int64_t m_SilentUntil = 0;
+        uint32_t m_Baudrate = 0;
+        uint32_t m_PendingBaudrate = 0;//SetBaudRate, applied on restart
+        uint32_t m_RestartBaudrate = 0;//restarting: applied once the restart ACK is out
+
+        //streaming and timing
+        uart::duration_ms_t m_RestartTime = 1000;
+        uart::duration_ms_t m_BackgroundAnalysisTime = 10000;
+        int64_t m_Now = 0;
+
+        Stats m_Stats;
+    };
+}
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef LIB_LD2412_FLASH_LOG_H_
+#define LIB_LD2412_FLASH_LOG_H_
+
+#include "lib_ld2412.hpp"
+#include <zephyr/fs/fcb.h>
+#include <zephyr/storage/flash_map.h>
+
+namespace hlk{
+    /**********************************************************************/
+    /* LD2412FlashLog                                                     */
+    /* Post-mortem log in a flash partition (Zephyr FCB, CONFIG_FCB):     */
+    /* presence transitions and Engineering snapshots, kept across        */
+    /* reboots. Records are collected in a RAM batch and written as one   */
+    /* FCB entry when the batch is full or flushMs passed, so flash sees  */
+    /* few, large writes. When the partition is full the oldest sector is */
+    /* erased (circular). A token bucket (ratePerMinute, burst) limits    */
+    /* what gets logged under bursty activity; what it drops is counted   */
+    /* in the next batch header.                                          */
+    /* Batch:  u8 version, u16 boot, u32 uptime ms, u16 dropped, records  */
+    /* Record: u8 type, varint ms since the previous record, payload      */
+    /* Add/Flush/Poll block on flash writes: one thread, not the reading  */
+    /* one if flash latency matters.                                      */
+    /**********************************************************************/
+    class LD2412FlashLog
+    {
+    public:
+        using PresenceResult = LD2412::PresenceResult;
+        using Engeneering = LD2412::Engeneering;
+
+        static constexpr const uint8_t kVersion = 1;
+        static constexpr const size_t kBatchHeader = 1 + 2 + 4 + 2;
+        //largest flash write block supported (Init fails with -ENOTSUP above it)
+        static constexpr const size_t kMaxWriteAlign = 16;
+
+        enum class RecordType: uint8_t { Transition = 1, Engineering = 2 };
+
+        struct Config
+        {
+            uint32_t flushMs = 60000;
+            uint16_t ratePerMinute = 60;
+            uint8_t burst = 20;
+            uint32_t minSnapshotMs = 10000;//Engineering snapshots at most this often
+        };
+
+        struct Record
+        {
+            uint16_t boot;
+            uint32_t uptimeMs;
+            RecordType type;
+            uint16_t droppedBefore;//rate limited records right before this batch (first record of a batch only)
+            PresenceResult presence;//Transition
+            Engeneering engineering;//Engineering
+        };
+
+        struct Stats
+        {
+            uint32_t records = 0;
+            uint32_t dropped = 0;//rate limited
+            uint32_t batches = 0;
+            uint32_t payloadBytes = 0;//record bytes handed to the log
+            uint32_t flashBytes = 0;//bytes written to flash, batch headers and FCB overhead included
+            uint32_t rotations = 0;//sector erases to make room
+            uint32_t errors = 0;
+        };
+
+        //batch - RAM for one batch (its size is the FCB entry size, < sector size);
+        //sectors - one per sector of the partition
+        LD2412FlashLog(std::span<uint8_t> batch, std::span<flash_sector> sectors);
+
+        //opens the partition, continues after the last boot's records; negative errno on failure
+        int Init(uint8_t flashAreaId, Config const& cfg);
+        int Init(uint8_t flashAreaId) { return Init(flashAreaId, Config{}); }
+        void SetConfig(Config const& cfg) { m_Cfg = cfg; }
+        uint16_t GetBoot() const { return m_Boot; }
+        //sectors of the partition in use (after Init)
+        uint8_t GetSectorCount() const { return m_Fcb.f_sector_cnt; }
+
+        //false if rate limited (or not initialized)
+        bool AddTransition(PresenceResult const& p, int64_t nowMs);
+        bool AddEngineering(Engeneering const& e, int64_t nowMs);
+
+        //writes the batch if flushMs passed since its first record
+        int Poll(int64_t nowMs);
+        int Flush();
+        //erases everything
+        int Clear();
+
+        //flushes, then all records in flash, oldest first; f(Record const&) returns false to stop
+        template<class F>
+        int Walk(F &&f)
+        {
+            using Fn = std::remove_reference_t<F>;
+            return WalkImpl([](Record const& r, void *pCtx) { return bool((*static_cast<Fn*>(pCtx))(r)); }, (void*)&f);
+        }
+
+        Stats const& GetStats() const { return m_Stats; }
+        void ResetStats() { m_Stats = {}; }
+    private:
+        using walk_cb_t = bool(*)(Record const& r, void *pCtx);
+
+        bool Allow(int64_t nowMs);
+        bool Append(RecordType t, const void *pPayload, size_t len, int64_t nowMs);
+        int Write(const uint8_t *pData, size_t len);
+        int WalkImpl(walk_cb_t cb, void *pCtx);
+
+        std::span<uint8_t> m_Batch;
+        std::span<flash_sector> m_Sectors;
+        fcb m_Fcb{};
+        bool m_Ready = false;
+        Config m_Cfg;
+        uint16_t m_Boot = 0;
+
+        size_t m_Used = 0;
+        int64_t m_BatchStartMs = 0;
+        int64_t m_LastRecordMs = 0;
+        int64_t m_LastSnapshotMs = INT64_MIN / 2;
+        uint16_t m_Dropped = 0;
+
+        uint32_t m_Tokens = 0;//in 1/60000 of a record
+        int64_t m_TokensMs = 0;
+
+        Stats m_Stats;
+    };
+}
+
+#endif
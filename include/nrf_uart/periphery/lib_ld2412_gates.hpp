@@ -0,0 +1,206 @@
+#ifndef LIB_LD2412_GATES_H_
+#define LIB_LD2412_GATES_H_
+
+#include "lib_ld2412.hpp"
+#include <bit>
+#include <cstring>
+
+//ARMv7E-M/ARMv8-M Mainline DSP extension (nRF52/53/54): byte-lane SIMD on 32 bit words.
+//Define NRF_UART_GATES_DSP=0 to force the portable 64 bit SWAR path.
+#ifndef NRF_UART_GATES_DSP
+#if defined(__ARM_FEATURE_SIMD32) && __ARM_FEATURE_SIMD32
+#define NRF_UART_GATES_DSP 1
+#else
+#define NRF_UART_GATES_DSP 0
+#endif
+#endif
+
+#if NRF_UART_GATES_DSP
+#include <arm_acle.h>
+#endif
+
+namespace hlk{
+    /**********************************************************************/
+    /* gates                                                              */
+    /* Per-frame kernels over LD2412::gate_array_t. The 14 gates are      */
+    /* packed into words and processed a byte lane at a time: with the    */
+    /* DSP extension 4 gates per instruction (uqsub8/usub8+sel/usada8),   */
+    /* otherwise 8 gates per 64 bit SWAR step. No branches per gate.      */
+    /* Masks have bit g set for gate g.                                   */
+    /**********************************************************************/
+    namespace gates
+    {
+        using gate_array_t = LD2412::gate_array_t;
+        using mask_t = uint16_t;
+        static constexpr const uint8_t kGateCount = LD2412::kGateCount;
+
+        namespace detail
+        {
+#if NRF_UART_GATES_DSP
+            using word_t = uint32_t;
+#else
+            using word_t = uint64_t;
+#endif
+            static constexpr const size_t kLanes = sizeof(word_t);
+            static constexpr const size_t kWords = (kGateCount + kLanes - 1) / kLanes;
+            static constexpr const word_t kOnes = word_t(~word_t(0)) / 0xff;//0x01 in every lane
+            static constexpr const word_t kHigh = kOnes * 0x80;
+
+            struct Packed
+            {
+                word_t w[kWords];
+            };
+
+            //lanes past the last gate are zero
+            inline Packed load(gate_array_t const& a)
+            {
+                Packed p{};
+                memcpy(p.w, a.data(), kGateCount);
+                return p;
+            }
+            inline gate_array_t store(Packed const& p)
+            {
+                gate_array_t a;
+                memcpy(a.data(), p.w, kGateCount);
+                return a;
+            }
+
+            //lane i of the result is bit i: gathers the lowest bit of every lane
+            //into the top lane with one multiply (no two products share a bit)
+            constexpr word_t gather_multiplier()
+            {
+                word_t m = 0;
+                for(size_t i = 0; i < kLanes; ++i)
+                    m |= word_t(1) << (8 * (kLanes - 1) - 7 * i);
+                return m;
+            }
+            inline uint32_t movemask(word_t laneMask)
+            {
+                return uint32_t(((laneMask & kOnes) * gather_multiplier()) >> (8 * (kLanes - 1)));
+            }
+
+#if NRF_UART_GATES_DSP
+            inline word_t sat_sub(word_t a, word_t b) { return __uqsub8(a, b); }
+            inline word_t max(word_t a, word_t b) { (void)__usub8(a, b); return __sel(a, b); }
+            inline word_t min(word_t a, word_t b) { (void)__usub8(a, b); return __sel(b, a); }
+            //0xff in lanes where a > b
+            inline word_t gt(word_t a, word_t b) { (void)__usub8(b, a); return __sel(0, ~word_t(0)); }
+            //0xff in lanes where a == b
+            inline word_t eq(word_t a, word_t b)
+            {
+                (void)__usub8(a, b);
+                word_t ge = __sel(~word_t(0), 0);
+                (void)__usub8(b, a);
+                return __sel(ge, 0);
+            }
+            inline uint32_t hsum(word_t a) { return __usada8(a, 0, 0); }
+#else
+            //per lane a - b modulo 256, no borrow between lanes
+            inline word_t sub_lanes(word_t a, word_t b) { return ((a | kHigh) - (b & ~kHigh)) ^ ((a ^ ~b) & kHigh); }
+            //0xff in lanes where a < b: the borrow out of bit 7 of each lane
+            inline word_t lt(word_t a, word_t b)
+            {
+                word_t d = sub_lanes(a, b);
+                word_t borrow = ((~a & b) | (~(a ^ b) & d)) & kHigh;
+                return (borrow >> 7) * 0xff;
+            }
+            inline word_t sat_sub(word_t a, word_t b) { return sub_lanes(a, b) & ~lt(a, b); }
+            inline word_t max(word_t a, word_t b) { return a ^ ((a ^ b) & lt(a, b)); }
+            inline word_t min(word_t a, word_t b) { return b ^ ((a ^ b) & lt(a, b)); }
+            inline word_t gt(word_t a, word_t b) { return lt(b, a); }
+            inline word_t eq(word_t a, word_t b)
+            {
+                word_t x = a ^ b;
+                word_t nonZero = (((x & ~kHigh) + ~kHigh) | x) & kHigh;
+                return ((~nonZero & kHigh) >> 7) * 0xff;
+            }
+            inline uint32_t hsum(word_t a)
+            {
+                //pairs of lanes into 16 bit lanes (<= 510), then all 16 bit lanes into the top one
+                constexpr word_t kEven = word_t(~word_t(0)) / 0xffff * 0xff;
+                constexpr word_t kOnes16 = word_t(~word_t(0)) / 0xffff;
+                word_t s = (a & kEven) + ((a >> 8) & kEven);
+                return uint32_t((s * kOnes16) >> (8 * kLanes - 16));
+            }
+#endif
+
+            template<class F>
+            inline Packed map(Packed const& a, Packed const& b, F &&f)
+            {
+                Packed r;
+                for(size_t i = 0; i < kWords; ++i)
+                    r.w[i] = f(a.w[i], b.w[i]);
+                return r;
+            }
+            template<class F>
+            inline mask_t mask(Packed const& a, Packed const& b, F &&f)
+            {
+                uint32_t m = 0;
+                for(size_t i = 0; i < kWords; ++i)
+                    m |= movemask(f(a.w[i], b.w[i])) << (i * kLanes);
+                return mask_t(m & ((1u << kGateCount) - 1));
+            }
+        }
+
+        //gates where energy > threshold
+        inline mask_t above(gate_array_t const& energy, gate_array_t const& threshold)
+        {
+            return detail::mask(detail::load(energy), detail::load(threshold), [](auto a, auto b){ return detail::gt(a, b); });
+        }
+
+        //max(a - b, 0) per gate
+        inline gate_array_t sat_sub(gate_array_t const& a, gate_array_t const& b)
+        {
+            return detail::store(detail::map(detail::load(a), detail::load(b), [](auto x, auto y){ return detail::sat_sub(x, y); }));
+        }
+
+        //|a - b| per gate, e.g. change against the previous frame
+        inline gate_array_t abs_diff(gate_array_t const& a, gate_array_t const& b)
+        {
+            return detail::store(detail::map(detail::load(a), detail::load(b), [](auto x, auto y){ return detail::sat_sub(x, y) | detail::sat_sub(y, x); }));
+        }
+
+        inline gate_array_t max(gate_array_t const& a, gate_array_t const& b)
+        {
+            return detail::store(detail::map(detail::load(a), detail::load(b), [](auto x, auto y){ return detail::max(x, y); }));
+        }
+
+        inline gate_array_t min(gate_array_t const& a, gate_array_t const& b)
+        {
+            return detail::store(detail::map(detail::load(a), detail::load(b), [](auto x, auto y){ return detail::min(x, y); }));
+        }
+
+        inline uint16_t sum(gate_array_t const& a)
+        {
+            auto p = detail::load(a);
+            uint32_t s = 0;
+            for(size_t i = 0; i < detail::kWords; ++i)
+                s += detail::hsum(p.w[i]);
+            return uint16_t(s);
+        }
+
+        struct MaxGate
+        {
+            uint8_t value;
+            uint8_t gate;//the nearest one on ties
+        };
+        inline MaxGate max_gate(gate_array_t const& a)
+        {
+            auto p = detail::load(a);
+            detail::word_t m = p.w[0];
+            for(size_t i = 1; i < detail::kWords; ++i)
+                m = detail::max(m, p.w[i]);
+            //fold the lanes onto lane 0; the zero fill shifted in never wins
+            for(size_t s = detail::kLanes / 2; s; s /= 2)
+                m = detail::max(m, m >> (8 * s));
+            uint8_t v = uint8_t(m);
+            detail::Packed b;
+            for(auto &w : b.w)
+                w = detail::kOnes * v;
+            mask_t hits = detail::mask(p, b, [](auto x, auto y){ return detail::eq(x, y); });
+            return {v, uint8_t(std::countr_zero(hits))};
+        }
+    }
+}
+
+#endif
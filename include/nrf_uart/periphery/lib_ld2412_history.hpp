@@ -0,0 +1,149 @@
+#ifndef LIB_LD2412_HISTORY_H_
+#define LIB_LD2412_HISTORY_H_
+
+#include "lib_ld2412.hpp"
+#include <iterator>
+
+namespace hlk{
+    /**********************************************************************/
+    /* LD2412History                                                      */
+    /* Fixed-memory presence history in three tiers:                      */
+    /*   raw     - every frame, compact (last seconds)                    */
+    /*   seconds - one aggregate per second with frames (last minutes)    */
+    /*   minutes - one aggregate per minute with frames (last hours)      */
+    /* Each tier is a ring that overwrites its oldest entry. A frame      */
+    /* updates the open second, a closed second is folded into the open   */
+    /* minute: O(1) per frame. Seconds/minutes without frames are not     */
+    /* stored, the aggregate's start time tells where the gaps are.       */
+    /* Feeding thread only, exporting included.                           */
+    /**********************************************************************/
+    class LD2412History
+    {
+    public:
+        using PresenceResult = LD2412::PresenceResult;
+        using Engeneering = LD2412::Engeneering;
+        using gate_array_t = LD2412::gate_array_t;
+
+        struct RawSample
+        {
+            uint32_t uptimeMs;
+            PresenceResult presence;
+            uint8_t moveMax;//highest gate energy; 0 for Simple mode frames
+            uint8_t stillMax;
+        };
+
+        struct Aggregate
+        {
+            uint32_t startS = 0;//uptime in seconds at the start of the interval
+            uint16_t frames = 0;
+            uint16_t occupied = 0;//frames with any target
+            uint16_t move = 0;//frames with a moving target
+            uint16_t still = 0;
+            uint16_t minDistance = UINT16_MAX;//cm, over reported targets; UINT16_MAX - none
+            uint16_t maxDistance = 0;
+            gate_array_t moveMax{};//per gate maximum energy (Energy mode frames)
+            gate_array_t stillMax{};
+
+            uint8_t OccupiedPercent() const { return frames ? uint8_t(occupied * 100u / frames) : 0; }
+        };
+
+        //oldest to newest over one tier
+        template<class T>
+        class View
+        {
+        public:
+            class iterator
+            {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = T;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const T*;
+                using reference = const T&;
+
+                iterator(View const *pView, size_t i): m_pView(pView), m_I(i) {}
+                reference operator*() const { return (*m_pView)[m_I]; }
+                pointer operator->() const { return &(*m_pView)[m_I]; }
+                iterator& operator++() { ++m_I; return *this; }
+                iterator operator++(int) { iterator r = *this; ++m_I; return r; }
+                bool operator==(iterator const& o) const { return m_I == o.m_I; }
+            private:
+                View const *m_pView;
+                size_t m_I;
+            };
+
+            View(std::span<const T> storage, size_t head, size_t count): m_Storage(storage), m_Head(head), m_Count(count) {}
+
+            size_t size() const { return m_Count; }
+            bool empty() const { return !m_Count; }
+            //0 - oldest
+            T const& operator[](size_t i) const { return m_Storage[(m_Head + i) % m_Storage.size()]; }
+            iterator begin() const { return {this, 0}; }
+            iterator end() const { return {this, m_Count}; }
+        private:
+            std::span<const T> m_Storage;
+            size_t m_Head;
+            size_t m_Count;
+        };
+
+        LD2412History(std::span<RawSample> raw, std::span<Aggregate> seconds, std::span<Aggregate> minutes);
+
+        //pEng - the frame's engineering data, nullptr for Simple mode frames
+        void Add(PresenceResult const& p, Engeneering const* pEng, int64_t nowMs);
+        void Add(LD2412::frame_snapshot_t const& f);
+        void Clear();
+
+        View<RawSample> GetRaw() const { return m_Raw.Get(); }
+        View<Aggregate> GetSeconds() const { return m_Seconds.Get(); }
+        View<Aggregate> GetMinutes() const { return m_Minutes.Get(); }
+        //the intervals still open (frames == 0 - nothing yet)
+        Aggregate const& GetOpenSecond() const { return m_Second; }
+        Aggregate const& GetOpenMinute() const { return m_Minute; }
+    private:
+        template<class T>
+        struct Ring
+        {
+            std::span<T> storage;
+            size_t head = 0;
+            size_t count = 0;
+
+            void Push(T const& v)
+            {
+                if (storage.empty())
+                    return;
+                if (count == storage.size())
+                {
+                    storage[head] = v;
+                    head = (head + 1) % storage.size();
+                }else
+                    storage[(head + count++) % storage.size()] = v;
+            }
+            void Clear() { head = count = 0; }
+            LD2412History::View<T> Get() const { return {storage, head, count}; }
+        };
+
+        static void Fold(Aggregate &a, PresenceResult const& p, Engeneering const* pEng);
+        static void Merge(Aggregate &into, Aggregate const& from);
+        void CloseSecond();
+        void CloseMinute();
+
+        Ring<RawSample> m_Raw;
+        Ring<Aggregate> m_Seconds;
+        Ring<Aggregate> m_Minutes;
+        Aggregate m_Second;
+        Aggregate m_Minute;
+    };
+
+    template<size_t RawN, size_t SecondsN, size_t MinutesN>
+    class LD2412HistoryStatic: public LD2412History
+    {
+    public:
+        LD2412HistoryStatic(): LD2412History(m_RawSamples, m_SecondAggs, m_MinuteAggs) {}
+    private:
+        RawSample m_RawSamples[RawN];
+        Aggregate m_SecondAggs[SecondsN];
+        Aggregate m_MinuteAggs[MinutesN];
+    };
+}
+
+#endif
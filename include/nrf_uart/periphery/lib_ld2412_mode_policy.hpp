@@ -0,0 +1,103 @@
+#ifndef LIB_LD2412_MODE_POLICY_H_
+#define LIB_LD2412_MODE_POLICY_H_
+
+#include "lib_ld2412.hpp"
+#include <atomic>
+
+namespace hlk{
+    /**********************************************************************/
+    /* LD2412ModePolicy                                                   */
+    /* Keeps the sensor in Simple mode (small frames, cheap to parse) and */
+    /* switches to Energy mode only while gate energies are wanted:       */
+    /*   Demand    - Request(ms) from any thread (diagnostics, tools)     */
+    /*   Ambiguous - a target is reported with less than ambiguousEnergy  */
+    /*   Flapping  - flapTransitions state changes within flapWindowMs    */
+    /*   Periodic  - every periodicMs                                     */
+    /* Energy mode is held for holdMs after the last trigger (or the      */
+    /* requested time, if longer); back in Simple mode, triggers other    */
+    /* than Demand wait minSimpleMs, so a noisy trigger can't make it     */
+    /* switch back and forth. Switching goes through                      */
+    /* LD2412::SwitchSystemMode, continuous reading keeps running around  */
+    /* it. Call Update from the reading thread after each frame.          */
+    /**********************************************************************/
+    class LD2412ModePolicy
+    {
+    public:
+        using PresenceResult = LD2412::PresenceResult;
+        using SystemMode = LD2412::SystemMode;
+        using ExpectedResult = LD2412::ExpectedResult;
+
+        static constexpr const uint8_t kMaxFlapTransitions = 8;
+
+        enum class Reason: uint8_t { Demand, Ambiguous, Flapping, Periodic, Count };
+
+        struct Config
+        {
+            uint32_t holdMs = 5000;
+            uint32_t minSimpleMs = 2000;
+            uint8_t ambiguousEnergy = 0;//0 - off
+            uint8_t flapTransitions = 0;//0 - off, up to kMaxFlapTransitions
+            uint32_t flapWindowMs = 3000;
+            uint32_t periodicMs = 0;//0 - off
+            uint32_t retryMs = 1000;//after a failed switch
+        };
+
+        struct Stats
+        {
+            uint64_t simpleMs = 0;//time in each mode
+            uint64_t energyMs = 0;
+            uint32_t switches = 0;
+            uint32_t failures = 0;
+            uint32_t lastSwitchMs = 0;//how long the commands of a switch took: the data gap
+            uint32_t maxSwitchMs = 0;
+            uint32_t triggers[size_t(Reason::Count)] = {};
+        };
+
+        LD2412ModePolicy(LD2412 &d): m_D(d) {}
+        LD2412ModePolicy(LD2412 &d, Config const& cfg): m_D(d), m_Cfg(cfg) {}
+
+        void SetConfig(Config const& cfg) { m_Cfg = cfg; }
+        Config const& GetConfig() const { return m_Cfg; }
+
+        //any thread: Energy mode for at least ms, starting with the next Update
+        void Request(uint32_t ms) { m_Requested.store(std::max(ms, 1u), std::memory_order_relaxed); }
+
+        //reading thread; evaluates the latest frame and switches if needed.
+        //Errors are those of the switch; it is retried after retryMs.
+        ExpectedResult Update(int64_t nowMs);
+
+        SystemMode GetMode() const { return m_D.GetSystemMode(); }
+        //the trigger of the current Energy stint
+        Reason GetReason() const { return m_Reason; }
+        //reading thread; time in the current mode included
+        Stats GetStats(int64_t nowMs) const;
+        void ResetStats(int64_t nowMs);
+    private:
+        void Trigger(Reason r, int64_t nowMs, int64_t untilMs);
+        void Account(int64_t nowMs);
+        bool Flapping(PresenceResult const& p, int64_t nowMs);
+        ExpectedResult Switch(SystemMode m, int64_t nowMs);
+
+        LD2412 &m_D;
+        Config m_Cfg;
+        std::atomic<uint32_t> m_Requested{0};
+
+        bool m_Started = false;
+        SystemMode m_Mode = SystemMode::Simple;//the mode time is accounted to
+        int64_t m_AccountedMs = 0;
+        int64_t m_EnergyUntilMs = 0;
+        int64_t m_SimpleSinceMs = 0;
+        int64_t m_LastEnergyMs = 0;//end of the last Energy stint, for periodicMs
+        int64_t m_RetryAtMs = 0;
+        Reason m_Reason = Reason::Demand;
+
+        LD2412::TargetState m_LastState = LD2412::TargetState::Clear;
+        int64_t m_Transitions[kMaxFlapTransitions] = {};
+        uint8_t m_TransitionHead = 0;
+        uint8_t m_TransitionCount = 0;
+
+        Stats m_Stats;
+    };
+}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef LIB_LD2412_STATS_H_
+#define LIB_LD2412_STATS_H_
+
+#include "lib_ld2412.hpp"
+
+namespace hlk{
+    /**********************************************************************/
+    /* LD2412EnergyStats                                                  */
+    /* Per-gate min/max/mean/variance of move and still energy over       */
+    /* tumbling windows of a fixed number of Energy frames. Integer only, */
+    /* O(gates) per frame. A finished window is published through         */
+    /* uart::Latest, so it can be read from any thread while streaming    */
+    /* goes on. Feed it with Add or attach it with LD2412::SetEnergyStats. */
+    /* One instance per window length.                                    */
+    /**********************************************************************/
+    class LD2412EnergyStats
+    {
+    public:
+        using Engeneering = LD2412::Engeneering;
+        using energy_stat_array_t = LD2412::energy_stat_array_t;
+
+        static constexpr const uint16_t kDefaultWindow = 64;
+
+        struct Window
+        {
+            energy_stat_array_t move{};
+            energy_stat_array_t still{};
+            uint16_t frames = 0;
+        };
+        using window_snapshot_t = uart::Latest<Window>::Snapshot;
+
+        LD2412EnergyStats(uint16_t windowFrames = kDefaultWindow);
+
+        //drops the current partial window
+        void SetWindow(uint16_t frames);
+        uint16_t GetWindow() const { return m_Window; }
+
+        //feeding thread
+        void Add(Engeneering const& e);
+        //feeding thread: the window in progress
+        Window GetCurrent() const;
+
+        //any thread: the last finished window (seq 0 - none finished yet)
+        window_snapshot_t GetLast() const { return m_Last.Read(); }
+    private:
+        //per gate columns, so min/max fold with the gates kernels
+        struct Acc
+        {
+            LD2412::gate_array_t min;
+            LD2412::gate_array_t max;
+            std::array<uint32_t, LD2412::kGateCount> sum;
+            std::array<uint32_t, LD2412::kGateCount> sumSq;//255^2 * 65535 still fits
+        };
+
+        void Reset();
+        static void Fold(Acc &acc, LD2412::gate_array_t const& v);
+        static void Finish(Acc const& acc, uint16_t n, energy_stat_array_t &dst);
+
+        uint16_t m_Window;
+        uint16_t m_N = 0;
+        Acc m_Move;
+        Acc m_Still;
+        uart::Latest<Window> m_Last;
+    };
+}
+
+#endif
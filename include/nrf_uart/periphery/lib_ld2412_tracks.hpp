@@ -0,0 +1,43 @@
+#ifndef LIB_LD2412_TRACKS_H_
+#define LIB_LD2412_TRACKS_H_
+
+#include "lib_ld2412.hpp"
+#include "../lib_track_filters.h"
+
+namespace hlk{
+    /**********************************************************************/
+    /* LD2412Tracks                                                       */
+    /* Smoothed move and still target distance (and velocity) with a      */
+    /* filter from lib_track_filters.h, e.g.                              */
+    /*   LD2412Tracks<uart::filters::Kalman<50, 15>> tracks;              */
+    /* A track restarts whenever its target comes back after being absent. */
+    /**********************************************************************/
+    template<class F>
+    class LD2412Tracks
+    {
+    public:
+        using Estimate = uart::filters::Estimate;
+        using TargetState = LD2412::TargetState;
+
+        LD2412Tracks(uint32_t maxGapMs = 2000): m_Move(maxGapMs), m_Still(maxGapMs) {}
+
+        void Add(LD2412::PresenceResult const& p, int64_t nowMs)
+        {
+            const bool move = p.m_State == TargetState::Move || p.m_State == TargetState::MoveAndStill;
+            const bool still = p.m_State == TargetState::Still || p.m_State == TargetState::MoveAndStill;
+            m_Move.Add(move, p.m_MoveDistance, nowMs);
+            m_Still.Add(still, p.m_StillDistance, nowMs);
+        }
+        void Add(LD2412::frame_snapshot_t const& f) { Add(f.value.m_Presence, f.uptimeMs); }
+
+        bool HasMove() const { return m_Move.Valid(); }
+        bool HasStill() const { return m_Still.Valid(); }
+        Estimate const& GetMove() const { return m_Move.Get(); }
+        Estimate const& GetStill() const { return m_Still.Get(); }
+    private:
+        uart::filters::Track<F> m_Move;
+        uart::filters::Track<F> m_Still;
+    };
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef LIB_LD2412_WIRE_H_
+#define LIB_LD2412_WIRE_H_
+
+#include "lib_ld2412.hpp"
+
+namespace hlk{
+    /**********************************************************************/
+    /* LD2412 wire format                                                 */
+    /* Compact binary form of PresenceResult (+ Engeneering) for slow     */
+    /* links. Frames are delta coded against the previous one, so the     */
+    /* encoder and the decoder each keep the last frame and the decoder   */
+    /* must see every frame in order; a keyframe (every keyframeInterval  */
+    /* frames, or forced) resets both to zero and resynchronizes.         */
+    /* Frame:                                                             */
+    /*   u8 flags   - bits 0-2 TargetState, 3 engineering, 4 keyframe,    */
+    /*                5-7 version                                         */
+    /*   u8 seq     - wraps; a gap makes the decoder wait for a keyframe  */
+    /*   move distance, still distance - zigzag varint deltas             */
+    /*   u8 move energy, u8 still energy                                  */
+    /* Engineering:                                                       */
+    /*   u8 max move gate | max still gate << 4, u8 light                 */
+    /*   move gates, still gates - each:                                  */
+    /*     u16 mask of the changed gates (bit 15: nibble deltas)          */
+    /*     new values, one byte per changed gate, or                      */
+    /*     nibble deltas (-7..7, two per byte, low first) where 8 escapes */
+    /*     to a new value in the bytes after the nibbles                  */
+    /*     whichever is shorter                                           */
+    /* Steady state: 6 bytes per Simple frame (7 raw), 10-24 per Energy   */
+    /* frame depending on how many gates jitter (39 raw). No allocation;  */
+    /* the decoder rejects malformed input without touching its state.    */
+    /**********************************************************************/
+    namespace wire
+    {
+        using PresenceResult = LD2412::PresenceResult;
+        using Engeneering = LD2412::Engeneering;
+
+        static constexpr const uint8_t kVersion = 0;
+        //header + 2 distances (3 byte varints) + energies + gate header + 2 * (mask + 14 values)
+        static constexpr const size_t kMaxFrame = 2 + 2 * 3 + 2 + 2 + 2 * (2 + LD2412::kGateCount);
+
+        enum class Error: uint8_t
+        {
+            Truncated,//not a whole frame
+            Malformed,//bad version/state/field
+            NeedKeyframe,//missed a frame: deltas can't be applied
+        };
+
+        //what a Decode produced
+        struct Frame
+        {
+            uint8_t seq;
+            bool keyframe;
+            bool hasEngineering;
+            PresenceResult presence;
+            Engeneering engineering;//valid if hasEngineering
+        };
+
+        //the state both sides delta against
+        struct Reference
+        {
+            uint16_t moveDistance = 0;
+            uint16_t stillDistance = 0;
+            LD2412::gate_array_t move{};
+            LD2412::gate_array_t still{};
+        };
+
+        class Encoder
+        {
+        public:
+            //keyframeInterval - frames between keyframes, 0 - only the first one
+            Encoder(uint16_t keyframeInterval = 64): m_KeyframeInterval(keyframeInterval) {}
+
+            //pEng - nullptr for Simple mode frames; returns the frame size, 0 if dst is too small
+            //(nothing is consumed then: the same frame can be encoded again)
+            size_t Encode(std::span<uint8_t> dst, PresenceResult const& p, Engeneering const* pEng);
+            size_t Encode(std::span<uint8_t> dst, LD2412::frame_snapshot_t const& f);
+            //the next frame is a keyframe (e.g. the receiver asked for one)
+            void ForceKeyframe() { m_Keyframe = true; }
+        private:
+            Reference m_Ref;
+            uint16_t m_KeyframeInterval;
+            uint16_t m_SinceKeyframe = 0;
+            uint8_t m_Seq = 0;
+            bool m_Keyframe = true;
+        };
+
+        class Decoder
+        {
+        public:
+            //decodes one frame from the front of src; *pUsed (if given) is its size, also on
+            //NeedKeyframe, so the rest of a buffer holding several frames can still be walked
+            std::expected<Frame, Error> Decode(std::span<const uint8_t> src, size_t *pUsed = nullptr);
+            //drops the reference: deltas are refused until the next keyframe
+            void Reset() { m_Synced = false; }
+            bool Synced() const { return m_Synced; }
+        private:
+            Reference m_Ref;
+            uint8_t m_Seq = 0;
+            bool m_Synced = false;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef LIB_LD2412_ZONES_H_
+#define LIB_LD2412_ZONES_H_
+
+#include "lib_ld2412.hpp"
+
+namespace hlk{
+    /**********************************************************************/
+    /* LD2412Zones                                                        */
+    /* Occupancy per zone from Energy frames. A zone is a gate range with */
+    /* its own move/still thresholds: it sees movement while any of its   */
+    /* gates' move energy exceeds the move threshold (still likewise) and */
+    /* keeps it for holdMs after the last such frame. Only state changes  */
+    /* are reported, as Events pushed to an optional queue. Every frame   */
+    /* costs a fixed number of packed compares per zone. Feed it with Add */
+    /* from the reading thread or with frames popped off the frame queue. */
+    /**********************************************************************/
+    class LD2412Zones
+    {
+    public:
+        using Engeneering = LD2412::Engeneering;
+        using TargetState = LD2412::TargetState;
+        using gate_array_t = LD2412::gate_array_t;
+
+        static constexpr const uint8_t kMaxZones = 8;
+
+        struct Zone
+        {
+            uint8_t firstGate;
+            uint8_t lastGate;//inclusive
+            uint8_t moveThreshold;
+            uint8_t stillThreshold;
+            uint16_t holdMs = 0;
+        };
+
+        struct Event
+        {
+            int64_t uptimeMs;
+            uint8_t zone;//index in the order of AddZone
+            TargetState from;
+            TargetState to;
+            uint16_t moveGates;//gates above the move threshold in this frame
+            uint16_t stillGates;
+        };
+        using event_queue_t = uart::FrameQueue<Event>;
+
+        //false if full or the range is invalid
+        bool AddZone(Zone const& z);
+        void ClearZones() { m_Count = 0; }
+        uint8_t GetZoneCount() const { return m_Count; }
+        Zone const& GetZone(uint8_t i) const { return m_Zones[i].cfg; }
+
+        //state changes are also pushed here; nullptr (default) disables it
+        void SetEventQueue(event_queue_t *pQueue) { m_pQueue = pQueue; }
+
+        //feeding thread; returns the mask of zones whose state changed
+        uint8_t Add(Engeneering const& e, int64_t nowMs);
+        //skips anything but Energy frames
+        uint8_t Add(LD2412::frame_snapshot_t const& f);
+
+        TargetState GetState(uint8_t zone) const { return m_Zones[zone].state; }
+        //feeding thread: the events of the last Add, in zone order
+        std::span<const Event> GetLastEvents() const { return {m_Events, m_EventCount}; }
+    private:
+        struct ZoneState
+        {
+            Zone cfg;
+            //zone threshold on its gates, 0xff (never exceeded) elsewhere
+            gate_array_t moveThr;
+            gate_array_t stillThr;
+            int64_t lastMoveMs = 0;
+            int64_t lastStillMs = 0;
+            bool move = false;
+            bool still = false;
+            TargetState state = TargetState::Clear;
+        };
+
+        ZoneState m_Zones[kMaxZones];
+        uint8_t m_Count = 0;
+        Event m_Events[kMaxZones];
+        uint8_t m_EventCount = 0;
+        event_queue_t *m_pQueue = nullptr;
+    };
+}
+
+#endif
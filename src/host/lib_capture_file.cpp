@@ -0,0 +1,60 @@
+#include <nrf_uart/host/lib_capture_file.h>
+#include <cerrno>
+
+namespace uart
+{
+    namespace capture
+    {
+        FileSink::~FileSink()
+        {
+            Close();
+        }
+
+        int FileSink::Open(const char *pPath)
+        {
+            Close();
+            m_pFile = fopen(pPath, "wb");
+            if (!m_pFile)
+                return -errno;
+            if (fwrite(kMagic, 1, sizeof(kMagic), m_pFile) != sizeof(kMagic))
+            {
+                Close();
+                return -EIO;
+            }
+            return 0;
+        }
+
+        void FileSink::Close()
+        {
+            if (m_pFile)
+                fclose(m_pFile);
+            m_pFile = nullptr;
+        }
+
+        void FileSink::Flush()
+        {
+            if (m_pFile)
+                fflush(m_pFile);
+        }
+
+        void FileSink::Write(const uint8_t *pRecord, size_t len)
+        {
+            if (m_pFile)
+                fwrite(pRecord, 1, len, m_pFile);
+        }
+
+        int load_file(const char *pPath, std::vector<uint8_t> &dst)
+        {
+            FILE *f = fopen(pPath, "rb");
+            if (!f)
+                return -errno;
+            dst.clear();
+            uint8_t buf[512];
+            for(size_t n; (n = fread(buf, 1, sizeof(buf), f)) > 0;)
+                dst.insert(dst.end(), buf, buf + n);
+            int r = ferror(f) ? -EIO : 0;
+            fclose(f);
+            return r;
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#include <nrf_uart/lib_uart.h>
+#include <nrf_uart/host/lib_uart_posix.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pty.h>
+#include <termios.h>
+#include <unistd.h>
+#include <cstring>
+#include <algorithm>
+
+namespace uart
+{
+    namespace
+    {
+        int make_raw(int fd)
+        {
+            termios t;
+            if (tcgetattr(fd, &t) != 0)
+                return -errno;
+            cfmakeraw(&t);
+            if (tcsetattr(fd, TCSANOW, &t) != 0)
+                return -errno;
+            return 0;
+        }
+    }
+
+    int PosixFd::open_tty(const char *pPath, uint32_t baudrate)
+    {
+        int fd = open(pPath, O_RDWR | O_NOCTTY);
+        if (fd < 0)
+            return -errno;
+        int r = make_raw(fd);
+        if (r == 0 && baudrate)
+            r = set_speed(fd, baudrate);
+        if (r != 0)
+        {
+            close(fd);
+            return r;
+        }
+        return fd;
+    }
+
+    int PosixFd::open_pty(int &master, int &slave, char *pSlaveName, size_t nameLen)
+    {
+        char name[64];
+        if (openpty(&master, &slave, name, nullptr, nullptr) != 0)
+            return -errno;
+        int r = make_raw(master);
+        if (r == 0)
+            r = make_raw(slave);
+        if (r != 0)
+        {
+            close(master);
+            close(slave);
+            return r;
+        }
+        if (pSlaveName && nameLen)
+        {
+            strncpy(pSlaveName, name, nameLen - 1);
+            pSlaveName[nameLen - 1] = 0;
+        }
+        return 0;
+    }
+
+    int PosixFd::Send(const uint8_t *pData, size_t len)
+    {
+        while(len)
+        {
+            ssize_t w = write(m_Fd, pData, len);
+            if (w < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return -errno;
+            }
+            pData += w;
+            len -= w;
+        }
+        m_pChannel->OnTxDone();
+        return 0;
+    }
+
+    int PosixFd::Poll(duration_ms_t maxWait)
+    {
+        if (!m_RxActive)
+            return 0;
+        int space = m_pChannel->GetRxFree();
+        if (!space)
+            return 0;
+
+        pollfd pfd{m_Fd, POLLIN, 0};
+        int r = poll(&pfd, 1, maxWait);
+        if (r < 0)
+            return errno == EINTR ? 0 : -errno;
+        if (r == 0)
+            return 0;
+        if (!(pfd.revents & POLLIN))
+            return (pfd.revents & (POLLHUP | POLLERR)) ? -EPIPE : 0;
+
+        uint8_t buf[64];
+        ssize_t n = read(m_Fd, buf, std::min<size_t>(sizeof(buf), space));
+        if (n < 0)
+            return (errno == EINTR || errno == EAGAIN) ? 0 : -errno;
+        if (n == 0)
+            return -EPIPE;
+        m_pChannel->OnRx(buf, n);
+        return n;
+    }
+
+    uint32_t PosixFd::GetBaudrate() const
+    {
+        return get_speed(m_Fd);
+    }
+
+    int PosixFd::SetBaudrate(uint32_t baudrate)
+    {
+        if (!isatty(m_Fd))
+            return -ENOTSUP;
+        if (!baudrate)
+            return -EINVAL;
+        return set_speed(m_Fd, baudrate);
+    }
+}
@@ -0,0 +1,36 @@
+//kept apart from lib_uart_posix.cpp: <asm/termbits.h> (termios2) and <termios.h> can't share a TU
+#include <nrf_uart/host/lib_uart_posix.h>
+#include <asm/termbits.h>
+#include <sys/ioctl.h>
+#include <cerrno>
+
+namespace uart
+{
+    int PosixFd::set_speed(int fd, uint32_t baudrate)
+    {
+        termios2 t;
+        if (ioctl(fd, TCGETS2, &t) != 0)
+            return -errno;
+        t.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+        t.c_cflag |= BOTHER | (BOTHER << IBSHIFT);
+        t.c_ispeed = baudrate;
+        t.c_ospeed = baudrate;
+        if (ioctl(fd, TCSETS2, &t) != 0)
+            return -errno;
+        //the driver rounds to what the adapter can do; refuse rates it can't get close to (>3%)
+        if (ioctl(fd, TCGETS2, &t) != 0)
+            return -errno;
+        uint32_t diff = t.c_ospeed > baudrate ? t.c_ospeed - baudrate : baudrate - t.c_ospeed;
+        if (uint64_t(diff) * 100 > uint64_t(baudrate) * 3)
+            return -EINVAL;
+        return 0;
+    }
+
+    uint32_t PosixFd::get_speed(int fd)
+    {
+        termios2 t;
+        if (ioctl(fd, TCGETS2, &t) != 0)
+            return 0;
+        return t.c_ospeed;
+    }
+}
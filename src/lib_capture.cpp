@@ -0,0 +1,132 @@
+#include <nrf_uart/lib_capture.h>
+#include <algorithm>
+#include <cstring>
+
+namespace uart
+{
+    namespace capture
+    {
+        /**********************************************************************/
+        /* Reader                                                             */
+        /**********************************************************************/
+        Reader::Reader(std::span<const uint8_t> capture):
+            m_Data(capture)
+        {
+            m_Valid = capture.size() >= sizeof(kMagic) && memcmp(capture.data(), kMagic, sizeof(kMagic)) == 0;
+            m_Pos = m_Valid ? sizeof(kMagic) : capture.size();
+        }
+
+        bool Reader::Next(Record &r)
+        {
+            size_t pos = m_Pos;
+            if (pos >= m_Data.size())
+                return false;
+            uint8_t h = m_Data[pos++];
+            uint32_t delta = 0;
+            for(int shift = 0;; shift += 7)
+            {
+                if (pos >= m_Data.size() || shift > 28)
+                    return false;
+                uint8_t b = m_Data[pos++];
+                delta |= uint32_t(b & 0x7f) << shift;
+                if (!(b & 0x80))
+                    break;
+            }
+            size_t len = (h & 0x7f) + 1;
+            if (m_Data.size() - pos < len)
+                return false;
+            r.dir = (h & 0x80) ? Dir::Tx : Dir::Rx;
+            r.deltaUs = delta;
+            r.data = m_Data.subspan(pos, len);
+            m_Pos = pos + len;
+            return true;
+        }
+
+        /**********************************************************************/
+        /* Ring                                                               */
+        /**********************************************************************/
+        void Ring::DropOldest()
+        {
+            size_t hdr = 1;
+            while(At(hdr) & 0x80)
+                ++hdr;
+            ++hdr;
+            size_t rec = hdr + (At(0) & 0x7f) + 1;
+            m_Head = (m_Head + rec) % m_Storage.size();
+            m_Used -= rec;
+            ++m_Dropped;
+        }
+
+        void Ring::Write(const uint8_t *pRecord, size_t len)
+        {
+            if (len > m_Storage.size())
+                return;
+            while(m_Storage.size() - m_Used < len)
+                DropOldest();
+            size_t tail = (m_Head + m_Used) % m_Storage.size();
+            size_t first = std::min(len, m_Storage.size() - tail);
+            memcpy(m_Storage.data() + tail, pRecord, first);
+            memcpy(m_Storage.data(), pRecord + first, len - first);
+            m_Used += len;
+        }
+
+        size_t Ring::CopyOut(std::span<uint8_t> dst) const
+        {
+            size_t total = sizeof(kMagic) + m_Used;
+            if (dst.size() < total)
+                return 0;
+            memcpy(dst.data(), kMagic, sizeof(kMagic));
+            for(size_t i = 0; i < m_Used; ++i)
+                dst[sizeof(kMagic) + i] = At(i);
+            return total;
+        }
+
+        void Ring::Dump() const
+        {
+            constexpr size_t kPerLine = 32;
+            printk("CAP %u\n", (unsigned)(sizeof(kMagic) + m_Used));
+            for(uint8_t b : kMagic) printk("%02x", b);
+            printk("\n");
+            for(size_t i = 0; i < m_Used; ++i)
+            {
+                printk("%02x", At(i));
+                if ((i + 1) % kPerLine == 0 || (i + 1) == m_Used)
+                    printk("\n");
+            }
+        }
+
+        /**********************************************************************/
+        /* Recorder                                                           */
+        /**********************************************************************/
+        void Recorder::Add(Dir d, const uint8_t *pData, size_t len)
+        {
+            k_spinlock_key_t key = k_spin_lock(&m_Lock);
+            uint64_t now = now_us();
+            while(len)
+            {
+                size_t n = std::min(len, kMaxRecordData);
+                uint8_t rec[kMaxRecordHeader + kMaxRecordData];
+                size_t l = 0;
+                rec[l++] = uint8_t((d == Dir::Tx ? 0x80 : 0) | (n - 1));
+                uint32_t delta = m_First ? 0 : uint32_t(std::min<uint64_t>(now - m_LastUs, UINT32_MAX));
+                do
+                {
+                    uint8_t b = delta & 0x7f;
+                    delta >>= 7;
+                    rec[l++] = delta ? (b | 0x80) : b;
+                }while(delta);
+                memcpy(rec + l, pData, n);
+                l += n;
+                m_Sink.Write(rec, l);
+
+                m_First = false;
+                m_LastUs = now;
+                ++m_Stats.records;
+                (d == Dir::Tx ? m_Stats.txBytes : m_Stats.rxBytes) += n;
+                pData += n;
+                len -= n;
+            }
+            k_spin_unlock(&m_Lock, key);
+        }
+    }
+}
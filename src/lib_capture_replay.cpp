@@ -0,0 +1,159 @@
+#include <nrf_uart/lib_capture_replay.h>
+#include <algorithm>
+
+namespace uart
+{
+    namespace capture
+    {
+        Replay::Replay(std::span<const uint8_t> capture, Speed speed, bool eosAtEnd):
+            m_Rx(capture),
+            m_Tx(capture),
+            m_Speed(speed),
+            m_EosAtEnd(eosAtEnd)
+        {
+            Rewind();
+        }
+
+        void Replay::Rewind()
+        {
+            m_Rx.Rewind();
+            m_Tx.Rewind();
+            m_HasCur = false;
+            m_CurSent = 0;
+            m_CapUs = m_CapTx = m_CapTxUs = 0;
+            m_FirstRecord = true;
+            m_TxRec = {};
+            m_TxPos = 0;
+            m_TxSeen = 0;
+            m_TxSkipped = 0;
+            m_Waiting = false;
+            m_SyncTx = 0;
+            m_Started = false;
+            m_Done = false;
+            m_Stats = {};
+            NextRx();
+        }
+
+        bool Replay::NextRx()
+        {
+            Record r;
+            while(m_Rx.Next(r))
+            {
+                //the first delta is relative to whatever preceded the capture
+                if (!m_FirstRecord)
+                    m_CapUs += r.deltaUs;
+                m_FirstRecord = false;
+                if (r.dir == Dir::Tx)
+                {
+                    m_CapTx += r.data.size();
+                    m_CapTxUs = m_CapUs;
+                    continue;
+                }
+                m_Cur = r;
+                m_CurSent = 0;
+                m_CurCapUs = m_CapUs;
+                m_CurTxBefore = m_CapTx;
+                m_CurTxCapUs = m_CapTxUs;
+                return m_HasCur = true;
+            }
+            return m_HasCur = false;
+        }
+
+        bool Replay::NextTx()
+        {
+            Record r;
+            while(m_Tx.Next(r))
+            {
+                if (r.dir == Dir::Tx)
+                {
+                    m_TxRec = r;
+                    m_TxPos = 0;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void Replay::SkipTx(uint64_t n)
+        {
+            //keeps the comparison aligned: the driver's next tx is checked against what followed
+            while(n)
+            {
+                if (m_TxPos >= m_TxRec.data.size() && !NextTx())
+                    return;
+                size_t k = size_t(std::min<uint64_t>(n, m_TxRec.data.size() - m_TxPos));
+                m_TxPos += k;
+                n -= k;
+            }
+        }
+
+        void Replay::OnTx(MemoryTransport &t, const uint8_t *pData, size_t len)
+        {
+            m_Stats.txBytes += len;
+            for(size_t i = 0; i < len; ++i)
+            {
+                if (m_TxPos >= m_TxRec.data.size() && !NextTx())
+                {
+                    m_Stats.txMismatch += len - i;
+                    break;
+                }
+                if (m_TxRec.data[m_TxPos++] != pData[i])
+                    ++m_Stats.txMismatch;
+            }
+            m_TxSeen += len;
+            m_TxWallUs = now_us();
+        }
+
+        void Replay::OnPoll(MemoryTransport &t)
+        {
+            uint64_t now = now_us();
+            if (!m_Started)
+            {
+                m_Started = true;
+                m_SyncWallUs = now;
+                m_SyncCapUs = 0;
+            }
+            while(m_HasCur)
+            {
+                if (m_CurTxBefore > m_TxSeen + m_TxSkipped)
+                {
+                    //waiting for the driver to send what it sent back then
+                    if (!m_Waiting)
+                    {
+                        m_Waiting = true;
+                        m_WaitWallUs = now;
+                    }
+                    if (m_Speed != Speed::Max || (now - std::max(m_WaitWallUs, m_TxWallUs)) < kStallUs)
+                        return;
+                    uint64_t skip = m_CurTxBefore - m_TxSeen - m_TxSkipped;
+                    SkipTx(skip);
+                    m_TxSkipped += skip;
+                    m_TxWallUs = now;
+                    ++m_Stats.stalls;
+                    m_Stats.txSkipped += uint32_t(skip);
+                }
+                m_Waiting = false;
+                if (m_CurTxBefore > m_SyncTx)
+                {
+                    m_SyncTx = m_CurTxBefore;
+                    m_SyncCapUs = m_CurTxCapUs;
+                    m_SyncWallUs = m_TxWallUs;
+                }
+                if (m_Speed == Speed::Original && (now - m_SyncWallUs) < (m_CurCapUs - m_SyncCapUs))
+                    return;
+                size_t n = t.Feed(m_Cur.data.data() + m_CurSent, m_Cur.data.size() - m_CurSent);
+                m_CurSent += n;
+                m_Stats.rxBytes += n;
+                if (m_CurSent < m_Cur.data.size())
+                    return;//backpressure
+                NextRx();
+            }
+            if (!m_Done)
+            {
+                m_Done = true;
+                if (m_EosAtEnd)
+                    t.SetEndOfStream(true);
+            }
+        }
+    }
+}
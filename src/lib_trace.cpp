@@ -0,0 +1,50 @@
+#include <nrf_uart/lib_trace.h>
+
+namespace uart
+{
+    namespace trace
+    {
+        const char* event_to_str(Event e)
+        {
+            switch(e)
+            {
+                case Event::None: return "None";
+                case Event::TxStart: return "TxStart";
+                case Event::RxEnable: return "RxEnable";
+                case Event::RxDisable: return "RxDisable";
+                case Event::RxRestart: return "RxRestart";
+                case Event::RxRead: return "RxRead";
+                case Event::RxTimeout: return "RxTimeout";
+                case Event::RxOverflow: return "RxOverflow";
+                case Event::Drain: return "Drain";
+                case Event::CmdSend: return "CmdSend";
+                case Event::CmdRetry: return "CmdRetry";
+                case Event::CmdStatus: return "CmdStatus";
+                case Event::CmdFailed: return "CmdFailed";
+                case Event::FrameLen: return "FrameLen";
+                case Event::FrameFooter: return "FrameFooter";
+                case Event::DataFrame: return "DataFrame";
+                case Event::DataFrameErr: return "DataFrameErr";
+                case Event::StrCmdSend: return "StrCmdSend";
+                case Event::StrCmdParams: return "StrCmdParams";
+                case Event::StrCmdDone: return "StrCmdDone";
+                case Event::StrDataFrame: return "StrDataFrame";
+                case Event::StrDataFrameErr: return "StrDataFrameErr";
+            }
+            return "unknown";
+        }
+
+        void Ring::Dump() const
+        {
+            uint32_t total = Total();
+            printk("TRC %u %u\n", (unsigned)sys_clock_hw_cycles_per_sec(), (unsigned)std::min<uint32_t>(total, m_Storage.size()));
+            ForEach([](entry_t const& e){
+                printk("%08x %02x %u ", (unsigned)e.ts, (unsigned)e.ev, (unsigned)e.len);
+                if (!e.len)
+                    printk("-");
+                for(size_t i = 0; i < std::min<size_t>(e.len, kPayloadSize); ++i) printk("%02x", e.payload[i]);
+                printk(" %s\n", event_to_str(e.ev));
+            });
+        }
+    }
+}
@@ -39,8 +39,16 @@ namespace uart
 	m_C.SetDefaultWait(m_PrevWait);
     }
 
+#ifndef NRF_UART_HOST
     Channel::Channel(const struct device *pUART):
-	m_pUART(pUART)
+	m_ZephyrUart(pUART),
+	m_pTransport(&m_ZephyrUart)
+    {
+    }
+#endif
+
+    Channel::Channel(Transport &t):
+	m_pTransport(&t)
     {
     }
 
@@ -50,18 +58,10 @@ namespace uart
 
     Channel::ExpectedResult Channel::Configure()
     {
-	uart_config cfg;
-	uart_config_get(m_pUART, &cfg);
-	//m_UARTRxTimeoutUS = (1'000'000 * kUARTRxTimeoutBits) / cfg.baudrate;
-	m_UARTRxTimeoutUS = 1'000 * m_DefaultWait;
-	if (m_UARTRxTimeoutUS == 0) m_UARTRxTimeoutUS = 4;
-
 	k_sem_init(&m_rx_sem, 0, 1);
 	k_sem_init(&m_tx_sem, 1, 1);
-	k_sem_init(&m_rx_ctrl, 0, 1);
-
-	uart_callback_set(m_pUART, uart_async_callback, this);
 
+	CALL_WITH_EXPECTED("Channel::Configure", m_pTransport->Configure(*this));
 	return std::ref(*this);
     }
 
@@ -75,162 +75,131 @@ namespace uart
 	return std::ref(*this);
     }
 
-    void Channel::uart_async_callback(const struct device *dev, uart_event *evt, void *user_data)
+    void Channel::OnRx(const uint8_t *pData, int len)
     {
-	Channel *pC = (Channel *)user_data;
-	switch(evt->type)
+	if (m_pCapture)
+	    m_pCapture->Add(capture::Dir::Rx, pData, len);
+	if (!m_pInternalRecvBuf)
+	    return;
+
+	++m_Stats.rx_events;
+	m_Stats.rx_bytes += len;
+	int to_write = len;
+	int read_pos = m_InternalRecvBufNextRead;
+	int write_pos = m_InternalRecvBufNextWrite;
+	if (read_pos < write_pos) read_pos += m_InternalRecvBufLen;
+	if ((write_pos != read_pos) && ((write_pos + to_write) >= read_pos))
 	{
-	    case UART_TX_ABORTED:
-		break;
-	    case UART_TX_DONE:
-		k_sem_give(&pC->m_tx_sem);
-	    break;
-	    case UART_RX_BUF_REQUEST:
+	    Trace(trace::Event::RxOverflow, uint16_t(write_pos), uint16_t(read_pos));
+	    ++m_Stats.overflows;
+	    m_Overflow = true;
+	    m_InternalRecvBufNextRead = ((write_pos + to_write + 1) % m_InternalRecvBufLen);
+	}
+
+	int left = m_InternalRecvBufLen - m_InternalRecvBufNextWrite;
+	if (left <= to_write) 
+	    to_write = left;
+
+	if (to_write)
+	{
+	    memcpy(m_pInternalRecvBuf + m_InternalRecvBufNextWrite, pData, to_write);
+	    m_InternalRecvBufNextWrite += to_write;
+	    m_InternalRecvBufNextWrite %= m_InternalRecvBufLen;
+	    int orig = to_write;
+	    to_write = len - to_write;
+	    if (to_write)
 	    {
-		if (pC->m_UARTAsyncBufNext != -1)
-		{
-		    pC->m_rx_state = true;
-		    pC->m_UARTAsyncBufNext ^= 1;
-		    uart_rx_buf_rsp(dev
-			    , pC->m_UARTAsyncBufs[pC->m_UARTAsyncBufNext]
-			    , kUARTAsyncBufSize);
-		}else
-		{
-		    //pC->m_rx_state = false;
-		}
+		memcpy(m_pInternalRecvBuf + m_InternalRecvBufNextWrite, pData + orig, to_write);
+		m_InternalRecvBufNextWrite += to_write;
 	    }
-	    break;
-	    case UART_RX_BUF_RELEASED:
-		break;
-	    case UART_RX_DISABLED:
-		pC->m_rx_state = false;
-		pC->m_UARTAsyncBufNext = -1;
-		k_sem_give(&pC->m_rx_ctrl);
-		break;
-	    case UART_RX_RDY:
-		{
-		    if (pC->m_pInternalRecvBuf)
-		    {
-			int to_write = evt->data.rx.len;
-			int read_pos = pC->m_InternalRecvBufNextRead;
-			int write_pos = pC->m_InternalRecvBufNextWrite;
-			if (read_pos < write_pos) read_pos += pC->m_InternalRecvBufLen;
-			if ((write_pos != read_pos) && ((write_pos + to_write) >= read_pos))
-			{
-			    pC->m_Overflow = true;
-			    pC->m_InternalRecvBufNextRead = ((write_pos + to_write + 1) % pC->m_InternalRecvBufLen);
-			}
-
-			int left = pC->m_InternalRecvBufLen - pC->m_InternalRecvBufNextWrite;
-			if (left <= to_write) 
-			    to_write = left;
-
-			if (to_write)
-			{
-			    memcpy(pC->m_pInternalRecvBuf + pC->m_InternalRecvBufNextWrite, 
-				    evt->data.rx.buf + evt->data.rx.offset,
-				    to_write);
-			    pC->m_InternalRecvBufNextWrite += to_write;
-			    pC->m_InternalRecvBufNextWrite %= pC->m_InternalRecvBufLen;
-			    int orig = to_write;
-			    to_write = evt->data.rx.len - to_write;
-			    if (to_write)
-			    {
-				memcpy(pC->m_pInternalRecvBuf + pC->m_InternalRecvBufNextWrite, 
-					evt->data.rx.buf + evt->data.rx.offset + orig,
-					to_write);
-				pC->m_InternalRecvBufNextWrite += to_write;
-			    }
-			    k_sem_give(&pC->m_rx_sem);
-			}else
-			{
-			}
-		    }
-		    else
-		    {
-		    }
-		}
-		break;
-	    case UART_RX_STOPPED:
-		if (pC->m_pInternalRecvBuf && pC->m_UARTAsyncBufNext != -1)
-		{
-		    pC->m_rx_state = false;
-		    pC->m_UARTAsyncBufNext = 0;
-		    uart_rx_enable(dev
-			    , pC->m_UARTAsyncBufs[0]
-			    , kUARTAsyncBufSize
-			    , pC->m_UARTRxTimeoutUS);
-		}
-		break;
+	    k_sem_give(&m_rx_sem);
 	}
     }
 
-    int Channel::uart_send()
+    int Channel::GetRxFree() const
+    {
+	if (!m_pInternalRecvBuf)
+	    return 0;
+	int used = (m_InternalRecvBufNextWrite - m_InternalRecvBufNextRead + m_InternalRecvBufLen) % m_InternalRecvBufLen;
+	return m_InternalRecvBufLen - 1 - used;
+    }
+
+    void Channel::OnTxDone()
     {
-	if (!m_SendLen) return 0;
-	int b = uart_fifo_fill(m_pUART, m_pSendBuf, m_SendLen);
-	if (b < 0) return b;
-	m_pSendBuf += b;
-	m_SendLen -= b;
-	return b;
+	k_sem_give(&m_tx_sem);
     }
 
-    int Channel::uart_recv()
+    int Channel::WaitRx(duration_ms_t wait)
     {
-	if (!m_RecvLen) return 0;
-	int b = uart_fifo_read(m_pUART, m_pRecvBuf, m_RecvLen);
-	if (b < 0) return b;
-	m_pRecvBuf += b;
-	m_RecvLen -= b;
-	return b;
+	if (!m_pTransport->IsPolled())
+	    return k_sem_take(&m_rx_sem, Z_TIMEOUT_MS(wait));
+
+	auto start = k_uptime_get();
+	while(true)
+	{
+	    duration_ms_t left = -1;
+	    if (wait >= 0)
+	    {
+		left = wait - duration_ms_t(k_uptime_get() - start);
+		if (left < 0) left = 0;
+	    }
+	    if (int r = m_pTransport->Poll(left); r > 0)
+		return k_sem_take(&m_rx_sem, K_NO_WAIT);
+	    else if (r < 0)
+		return r;
+	    if (left == 0)
+		return -EAGAIN;
+	    ++m_Stats.poll_spins;
+	    k_yield();
+	}
     }
 
     Channel::ExpectedResult Channel::Send(const uint8_t *pData, size_t len)
     {
 	CALL_WITH_EXPECTED("Channel::Send", k_sem_take(&m_tx_sem, Z_TIMEOUT_MS(m_DefaultWait)));
-	if (m_Dbg)
+	if constexpr (kDebugLevel >= DebugLevel::Bytes)
 	{
 	    FMT_PRINTLN("Channel::Send: {}", std::span<const uint8_t>{(const uint8_t*)pData, len});
 	}
-	m_pSendBuf = pData;
-	m_SendLen = len;
-	CALL_WITH_EXPECTED("Channel::Send (uart_tx)", uart_tx(m_pUART, pData, len, SYS_FOREVER_US));
+	if (m_pTrace)
+	{
+	    uint8_t first[4] = {0};
+	    memcpy(first, pData, std::min(len, sizeof(first)));
+	    m_pTrace->Add(trace::Event::TxStart, uint16_t(len), first);
+	}
+	if (m_pCapture)
+	    m_pCapture->Add(capture::Dir::Tx, pData, len);
+	m_Stats.tx_bytes += len;
+	CALL_WITH_EXPECTED("Channel::Send (transport)", m_pTransport->Send(pData, len));
 	return std::ref(*this);
     }
 
     void Channel::AllowReadUpTo(uint8_t *pData, size_t len)
     {
-	if (m_Dbg)
+	if constexpr (kDebugLevel >= DebugLevel::Bytes)
 	{
 	    FMT_PRINTLN("Channel::AllowReadUpTo: {}", len);
 	}
-	if (m_rx_state)
+	if (m_pTransport->IsRxActive())
 	    StopReading();
 
 	m_pInternalRecvBuf = pData;
         m_InternalRecvBufLen = len;
         m_InternalRecvBufNextWrite = 0;
         m_InternalRecvBufNextRead = 0;
-	m_UARTAsyncBufNext = 0;
-	auto r = uart_rx_enable(m_pUART, m_UARTAsyncBufs[0], kUARTAsyncBufSize, m_UARTRxTimeoutUS);
-	if (m_Dbg && (r != 0))
+	auto r = m_pTransport->StartRx();
+	Trace(trace::Event::RxEnable, int16_t(r), uint16_t(len));
+	if constexpr (kDebugLevel >= DebugLevel::Bytes)
 	{
-	    FMT_PRINTLN("uart_rx_enable: {}", r);
+	    if (r != 0)
+		FMT_PRINTLN("uart_rx_enable: {}", r);
 	}
     }
 
     void Channel::StopReading(bool dbg)
     {
-	k_sem_reset(&m_rx_ctrl);
-	int r = uart_rx_disable(m_pUART);
-	if ((r < 0) && m_Dbg)
-	{
-	    printk("rx disable call failed with %d\n", r);
-	}
-	r = k_sem_take(&m_rx_ctrl, Z_TIMEOUT_MS(10/*m_DefaultWait*/));
-	if (!m_rx_state)
-	    r = 0;
-
+	int r = m_pTransport->StopRx();
+	Trace(trace::Event::RxDisable, int16_t(r));
 	if (r < 0)
 	{
 	    printk("Channel::StopReading: could not disable RX: %d\n", r);
@@ -244,8 +213,10 @@ namespace uart
 		}
 		else if (m_InternalRecvBufNextWrite != m_InternalRecvBufNextRead)
 		{
-		    if (m_Dbg)
+		    if constexpr (kDebugLevel >= DebugLevel::Bytes)
+		    {
 			FMT_PRINTLN("Channel::StopReading: unread data in buf: {}", std::span<const uint8_t>{m_pInternalRecvBuf + m_InternalRecvBufNextRead, (size_t)(m_InternalRecvBufNextWrite - m_InternalRecvBufNextRead)});
+		    }
 		}
 	    }
 	}
@@ -253,7 +224,6 @@ namespace uart
         m_InternalRecvBufLen = 0;
         m_InternalRecvBufNextWrite = 0;
         m_InternalRecvBufNextRead = 0;
-	m_UARTAsyncBufNext = -1;
     }
 
     size_t Channel::ReadInternal(uint8_t *pBuf, size_t len)
@@ -264,7 +234,7 @@ namespace uart
 	    int avail = m_InternalRecvBufLen - m_InternalRecvBufNextRead;
 	    int n = std::min(avail, (int)len);
 	    memcpy(pBuf, m_pInternalRecvBuf + m_InternalRecvBufNextRead, n);
-	    if (m_Dbg) 
+	    if constexpr (kDebugLevel >= DebugLevel::Bytes)
 	    {
 		printk("RI{%d - %d}: ", len, n);
 		for(int i = 0; i < n; ++i) printk("%02x", *(m_pInternalRecvBuf + m_InternalRecvBufNextRead + i));
@@ -280,7 +250,7 @@ namespace uart
 	int left = len - read_bytes;
 	int n = std::min(avail, left);
 	memcpy(pBuf + read_bytes, m_pInternalRecvBuf + m_InternalRecvBufNextRead, n);
-	if (m_Dbg) 
+	if constexpr (kDebugLevel >= DebugLevel::Bytes)
 	{
 	    printk("RI{%d - %d}: ", len, n);
 	    for(int i = 0; i < n; ++i) printk("%02x", *(m_pInternalRecvBuf + m_InternalRecvBufNextRead + i));
@@ -317,30 +287,38 @@ namespace uart
 
 	if (m_pInternalRecvBuf)
 	{
+	    if (m_pTransport->IsPolled())
+		m_pTransport->Poll(0);
 	    int read = ReadInternal(pBuf, len);
 	    if (read == len)
 		return RetVal<size_t>{*this, len};
 	    if (wait == 0)
 		return RetVal<size_t>{*this, size_t(read)};
 
-	    if (m_UARTAsyncBufNext == -1)
+	    if (!m_pTransport->IsRxActive())
 	    {
-		if (m_Dbg)
+		Trace(trace::Event::RxRestart);
+		if constexpr (kDebugLevel >= DebugLevel::Bytes)
+		{
 		    printk("Read: restarting recv\r\n");
-		m_UARTAsyncBufNext = 0;
-		uart_rx_enable(m_pUART, m_UARTAsyncBufs[0], kUARTAsyncBufSize, m_UARTRxTimeoutUS);
+		}
+		m_pTransport->StartRx();
 	    }
 
+	    Trace(trace::Event::RxRead, uint16_t(len), uint16_t(read));
 	    //FMT_PRINTLN("Read len: {}; read: {}", len, read);
 	    pBuf += read;
 	    int left = (int)len - read;
 	    while(left)
 	    {
 		//CALL_WITH_EXPECTED("Channel::Read(internal)", k_sem_take(&m_rx_sem, Z_TIMEOUT_MS(wait)));
-		if (auto err = k_sem_take(&m_rx_sem, Z_TIMEOUT_MS(wait)); err != 0)
+		if (auto err = WaitRx(wait); err != 0)
 		{
-		    if (m_Dbg)
-			printk("Read failed. write pos: %d; read pos: %d; (buf idx=%d; state=%d)\r\n", m_InternalRecvBufNextWrite, m_InternalRecvBufNextRead, m_UARTAsyncBufNext, m_rx_state);
+		    Trace(trace::Event::RxTimeout, uint16_t(m_InternalRecvBufNextWrite), uint16_t(m_InternalRecvBufNextRead), uint8_t(m_pTransport->IsRxActive()));
+		    if constexpr (kDebugLevel >= DebugLevel::Bytes)
+		    {
+			printk("Read failed. write pos: %d; read pos: %d; (rx active=%d)\r\n", m_InternalRecvBufNextWrite, m_InternalRecvBufNextRead, m_pTransport->IsRxActive());
+		    }
 		    //FMT_PRINTLN("Read failed. write pos: {}; read pos: {}; (buf idx={})", m_InternalRecvBufNextWrite, m_InternalRecvBufNextRead, m_UARTAsyncBufNext);
 		    return std::unexpected(Err{"Channel::Read(internal)", err});
 		}
@@ -356,7 +334,11 @@ namespace uart
     Channel::ExpectedResult Channel::Drain(bool stopAtEnd)
     {
 	uint8_t buf[8];
-	if (m_Dbg) printk("Draining...\n");
+	Trace(trace::Event::Drain);
+	if constexpr (kDebugLevel >= DebugLevel::Bytes)
+	{
+	    printk("Draining...\n");
+	}
 	while(true)
 	{
 	    auto r = Read(buf, sizeof(buf), 0);
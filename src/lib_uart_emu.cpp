@@ -0,0 +1,85 @@
+#include <nrf_uart/lib_uart_emu.h>
+#include <algorithm>
+#include <cstring>
+
+namespace uart
+{
+    namespace emu
+    {
+        uint32_t Outbox::Rand()
+        {
+            //xorshift32
+            m_Rand ^= m_Rand << 13;
+            m_Rand ^= m_Rand >> 17;
+            m_Rand ^= m_Rand << 5;
+            return m_Rand;
+        }
+
+        bool Outbox::Queue(int64_t due, const uint8_t *pData, size_t len)
+        {
+            if (full())
+            {
+                ++m_Stats.queueFull;
+                return false;
+            }
+            len = std::min(len, kMaxFrame);
+            Slot &s = m_Slots[(m_Head + m_Count) % kMaxQueued];
+            s.due = due;
+            s.sent = 0;
+            s.len = 0;
+            if (Chance(m_Faults.garbage))
+            {
+                ++m_Stats.garbage;
+                size_t n = std::min<size_t>(1 + Rand() % 8, kMaxFrame - len);
+                for(; s.len < n; ++s.len)
+                    s.data[s.len] = uint8_t(Rand());
+            }
+            uint8_t *pFrame = s.data + s.len;
+            std::memcpy(pFrame, pData, len);
+            if (len && Chance(m_Faults.corrupt))
+            {
+                ++m_Stats.corrupted;
+                pFrame[Rand() % len] ^= uint8_t(1 + Rand() % 255);
+            }
+            if (len > 1 && Chance(m_Faults.truncate))
+            {
+                ++m_Stats.truncated;
+                len = 1 + Rand() % (len - 1);
+            }
+            s.len += len;
+            ++m_Count;
+            return true;
+        }
+
+        void Outbox::Deliver(MemoryTransport &t, int64_t now)
+        {
+            if (m_WireModel)
+            {
+                if (m_LastDeliver >= 0)
+                    m_WireCredit += uint32_t(now - m_LastDeliver) * (t.GetBaudrate() / 10);
+                m_WireCredit = std::min<uint32_t>(m_WireCredit, kMaxFrame * kMaxQueued * 1000);
+            }
+            m_LastDeliver = now;
+
+            while(m_Count)
+            {
+                Slot &s = m_Slots[m_Head];
+                if (s.due > now)
+                    break;
+                size_t n = s.len - s.sent;
+                if (m_WireModel)
+                    n = std::min<size_t>(n, m_WireCredit / 1000);
+                if (!n)
+                    break;
+                size_t fed = t.Feed(s.data + s.sent, n);
+                s.sent += fed;
+                if (m_WireModel)
+                    m_WireCredit -= fed * 1000;
+                if (s.sent < s.len)
+                    break;
+                m_Head = (m_Head + 1) % kMaxQueued;
+                --m_Count;
+            }
+        }
+    }
+}
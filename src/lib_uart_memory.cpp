@@ -0,0 +1,64 @@
+#include <nrf_uart/lib_uart.h>
+#include <nrf_uart/lib_uart_memory.h>
+#include <algorithm>
+
+namespace uart
+{
+    MemoryTransport::MemoryTransport(std::span<uint8_t> rxStorage, uint32_t baudrate):
+        m_Storage(rxStorage),
+        m_Baudrate(baudrate)
+    {
+    }
+
+    size_t MemoryTransport::Feed(const uint8_t *pData, size_t len)
+    {
+        size_t n = std::min(len, m_Storage.size() - m_Used);
+        for(size_t i = 0; i < n; ++i)
+            m_Storage[(m_Head + m_Used + i) % m_Storage.size()] = pData[i];
+        m_Used += n;
+        if (n)
+            m_LastFeedUs = k_ticks_to_us_floor64(k_uptime_ticks());
+        return n;
+    }
+
+    int MemoryTransport::Send(const uint8_t *pData, size_t len)
+    {
+        if (m_pPeer)
+            m_pPeer->OnTx(*this, pData, len);
+        m_pChannel->OnTxDone();
+        return 0;
+    }
+
+    int MemoryTransport::Poll(duration_ms_t maxWait)
+    {
+        if (m_pPeer)
+            m_pPeer->OnPoll(*this);
+        if (!m_RxActive)
+            return 0;
+        if (!m_Used)
+            return m_EndOfStream ? -ENODATA : 0;
+
+        //a partly filled receive buffer is held until the line was idle long enough
+        size_t ready = m_Used;
+        if (m_RxBufSize && ready % m_RxBufSize
+            && k_ticks_to_us_floor64(k_uptime_ticks()) - m_LastFeedUs < uint64_t(m_RxIdleUS))
+            ready -= ready % m_RxBufSize;
+
+        //unlike a wire, memory can apply backpressure: never overflow the channel
+        int total = 0;
+        while(ready)
+        {
+            size_t space = m_pChannel->GetRxFree();
+            if (!space)
+                break;
+            //contiguous part up to the storage end
+            size_t n = std::min({ready, m_Storage.size() - m_Head, space});
+            m_pChannel->OnRx(m_Storage.data() + m_Head, n);
+            m_Head = (m_Head + n) % m_Storage.size();
+            m_Used -= n;
+            ready -= n;
+            total += n;
+        }
+        return total;
+    }
+}
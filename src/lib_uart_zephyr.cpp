@@ -0,0 +1,244 @@
+#include <nrf_uart/lib_uart.h>
+
+namespace uart
+{
+    int ZephyrUart::Configure(Channel &c)
+    {
+	Transport::Configure(c);
+	uart_config cfg;
+	if (uart_config_get(m_pUART, &cfg) != 0)
+	    cfg.baudrate = kFallbackBaudrate;
+	m_UARTRxTimeoutUS = rx_idle_timeout_us(cfg.baudrate);
+
+	k_sem_init(&m_rx_ctrl, 0, 1);
+
+	if constexpr (kBackend == Backend::Async)
+	    return uart_callback_set(m_pUART, uart_async_callback, this);
+	else if constexpr (kBackend == Backend::Irq)
+	{
+	    uart_irq_rx_disable(m_pUART);
+	    uart_irq_tx_disable(m_pUART);
+	    return uart_irq_callback_user_data_set(m_pUART, uart_irq_callback, this);
+	}
+	return 0;
+    }
+
+    uint32_t ZephyrUart::GetBaudrate() const
+    {
+	uart_config cfg;
+	if (uart_config_get(m_pUART, &cfg) != 0)
+	    return 0;
+	return cfg.baudrate;
+    }
+
+    int ZephyrUart::SetBaudrate(uint32_t baudrate)
+    {
+#if defined(CONFIG_UART_USE_RUNTIME_CONFIGURE)
+	uart_config cfg;
+	if (int r = uart_config_get(m_pUART, &cfg); r != 0)
+	    return r;
+	if (cfg.baudrate == baudrate)
+	    return 0;
+	const bool rx = IsRxActive();
+	if (rx)
+	    StopRx();
+	cfg.baudrate = baudrate;
+	int r = uart_configure(m_pUART, &cfg);
+	if (r == 0)
+	    m_UARTRxTimeoutUS = rx_idle_timeout_us(baudrate);
+	if (rx)
+	{
+	    if (int rs = StartRx(); r == 0)
+		r = rs;
+	}
+	return r;
+#else
+	return -ENOTSUP;
+#endif
+    }
+
+    void ZephyrUart::uart_async_callback(const struct device *dev, uart_event *evt, void *user_data)
+    {
+	ZephyrUart *pT = (ZephyrUart *)user_data;
+	switch(evt->type)
+	{
+	    case UART_TX_ABORTED:
+		break;
+	    case UART_TX_DONE:
+		pT->m_pChannel->OnTxDone();
+	    break;
+	    case UART_RX_BUF_REQUEST:
+	    {
+		if (pT->m_UARTAsyncBufNext != -1)
+		{
+		    pT->m_rx_state = true;
+		    pT->m_UARTAsyncBufNext ^= 1;
+		    uart_rx_buf_rsp(dev
+			    , pT->m_UARTAsyncBufs[pT->m_UARTAsyncBufNext]
+			    , kUARTAsyncBufSize);
+		}else
+		{
+		    //pT->m_rx_state = false;
+		}
+	    }
+	    break;
+	    case UART_RX_BUF_RELEASED:
+		break;
+	    case UART_RX_DISABLED:
+		pT->m_rx_state = false;
+		pT->m_UARTAsyncBufNext = -1;
+		k_sem_give(&pT->m_rx_ctrl);
+		break;
+	    case UART_RX_RDY:
+		pT->m_pChannel->OnRx(evt->data.rx.buf + evt->data.rx.offset, evt->data.rx.len);
+		break;
+	    case UART_RX_STOPPED:
+		if (pT->m_UARTAsyncBufNext != -1)
+		{
+		    pT->m_rx_state = false;
+		    pT->m_UARTAsyncBufNext = 0;
+		    uart_rx_enable(dev
+			    , pT->m_UARTAsyncBufs[0]
+			    , kUARTAsyncBufSize
+			    , pT->m_UARTRxTimeoutUS);
+		}
+		break;
+	}
+    }
+
+    void ZephyrUart::uart_irq_callback(const struct device *dev, void *user_data)
+    {
+	ZephyrUart *pT = (ZephyrUart *)user_data;
+	if (!uart_irq_update(dev))
+	    return;
+
+	while(uart_irq_rx_ready(dev) > 0)
+	{
+	    //the async bounce buffers are unused in this mode and serve as ISR scratch
+	    pT->m_pRecvBuf = pT->m_UARTAsyncBufs[0];
+	    pT->m_RecvLen = kUARTAsyncBufSize;
+	    int b = pT->uart_recv();
+	    if (b <= 0)
+		break;
+	    pT->m_pChannel->OnRx(pT->m_UARTAsyncBufs[0], b);
+	}
+
+	if (pT->m_TxPending)
+	{
+	    if (pT->m_SendLen && uart_irq_tx_ready(dev) > 0 && pT->uart_send() < 0)
+		pT->m_SendLen = 0;
+	    //the last fill only queues the bytes: done, like the async backend's UART_TX_DONE,
+	    //is when they are on the line (drivers without tx_complete return -ENOSYS)
+	    if (!pT->m_SendLen && uart_irq_tx_complete(dev) != 0)
+	    {
+		pT->m_TxPending = false;
+		uart_irq_tx_disable(dev);
+		pT->m_pChannel->OnTxDone();
+	    }
+	}
+    }
+
+    int ZephyrUart::uart_send()
+    {
+	if (!m_SendLen) return 0;
+	int b = uart_fifo_fill(m_pUART, m_pSendBuf, m_SendLen);
+	if (b < 0) return b;
+	m_pSendBuf += b;
+	m_SendLen -= b;
+	return b;
+    }
+
+    int ZephyrUart::uart_recv()
+    {
+	if (!m_RecvLen) return 0;
+	int b = uart_fifo_read(m_pUART, m_pRecvBuf, m_RecvLen);
+	if (b < 0) return b;
+	m_pRecvBuf += b;
+	m_RecvLen -= b;
+	return b;
+    }
+
+    int ZephyrUart::Send(const uint8_t *pData, size_t len)
+    {
+	m_pSendBuf = pData;
+	m_SendLen = len;
+	if constexpr (kBackend == Backend::Async)
+	    return uart_tx(m_pUART, pData, len, SYS_FOREVER_US);
+	else if constexpr (kBackend == Backend::Irq)
+	{
+	    m_TxPending = true;
+	    uart_irq_tx_enable(m_pUART);
+	    return 0;
+	}
+	else
+	{
+	    for(; m_SendLen; --m_SendLen)
+		uart_poll_out(m_pUART, *m_pSendBuf++);
+	    m_pChannel->OnTxDone();
+	    return 0;
+	}
+    }
+
+    int ZephyrUart::StartRx()
+    {
+	m_UARTAsyncBufNext = 0;
+	if constexpr (kBackend == Backend::Async)
+	    return uart_rx_enable(m_pUART, m_UARTAsyncBufs[0], kUARTAsyncBufSize, m_UARTRxTimeoutUS);
+	else if constexpr (kBackend == Backend::Irq)
+	{
+	    m_rx_state = true;
+	    uart_irq_rx_enable(m_pUART);
+	    return 0;
+	}
+	else
+	{
+	    m_rx_state = true;
+	    return 0;
+	}
+    }
+
+    int ZephyrUart::StopRx()
+    {
+	int r = 0;
+	if constexpr (kBackend == Backend::Async)
+	{
+	    k_sem_reset(&m_rx_ctrl);
+	    r = uart_rx_disable(m_pUART);
+	    r = k_sem_take(&m_rx_ctrl, Z_TIMEOUT_MS(10/*m_DefaultWait*/));
+	    if (!m_rx_state)
+		r = 0;
+	}
+	else
+	{
+	    if constexpr (kBackend == Backend::Irq)
+		uart_irq_rx_disable(m_pUART);
+	    m_rx_state = false;
+	}
+	m_UARTAsyncBufNext = -1;
+	return r;
+    }
+
+    int ZephyrUart::Poll(duration_ms_t maxWait)
+    {
+	if constexpr (kBackend == Backend::Poll)
+	{
+	    if (!m_rx_state)
+		return 0;
+	    uint8_t buf[kUARTAsyncBufSize];
+	    int total = 0;
+	    int n = 0;
+	    do
+	    {
+		n = 0;
+		while(n < kUARTAsyncBufSize && uart_poll_in(m_pUART, &buf[n]) == 0)
+		    ++n;
+		if (n)
+		    m_pChannel->OnRx(buf, n);
+		total += n;
+	    }while(n == kUARTAsyncBufSize);
+	    return total;
+	}
+	else
+	    return 0;
+    }
+}
@@ -19,85 +19,23 @@
 
 namespace dfr
 {
-    template<class T>
-    struct read_cfg_t
-    {
-        T min = 0;
-        T max = 0;
-    };
-    using read_float_cfg_t = read_cfg_t<float>;
-    using read_uint8_cfg_t = read_cfg_t<uint8_t>;
-
-    struct read_float_from_str_t
-    {
-        using functional_read_helper = void;
-        float &dstVar;
-        char until = ' ';
-        char dstStr[16];
-        bool consume_last = true;
-        read_float_cfg_t cfg{};
-
-        static constexpr size_t size() { return sizeof(dstStr); }
-        size_t rt_size() const { return sizeof(dstStr); }
-        auto run(uart::Channel &c) { 
-            using ExpectedResult = std::expected<uart::Channel::Ref, ::Err>;
-            auto r = uart::primitives::read_until_into(c, until, (uint8_t*)dstStr, sizeof(dstStr), consume_last, {}); 
-            if (!r) return r;
-            char *pEnd = dstStr;
-            dstVar = strtof(dstStr, &pEnd);
-            if (pEnd == dstStr)
-            {
-                return ExpectedResult(std::unexpected(::Err{"failed to convert"}));
-            }
-            if (cfg.min != cfg.max)
-            {
-                if (dstVar < cfg.min || dstVar > cfg.max)
-                    return ExpectedResult(std::unexpected(::Err{"failed validation"}));
-            }
-            return r;
-        } 
-    };
-
-    struct read_uint8_from_str_t
-    {
-        using functional_read_helper = void;
-        uint8_t &dstVar;
-        char until = ' ';
-        char dstStr[16];
-        bool consume_last = true;
-        read_uint8_cfg_t cfg{};
-
-        static constexpr size_t size() { return sizeof(dstStr); }
-        size_t rt_size() const { return sizeof(dstStr); }
-        auto run(uart::Channel &c) { 
-            using ExpectedResult = std::expected<uart::Channel::Ref, ::Err>;
-            auto r = uart::primitives::read_until_into(c, until, (uint8_t*)dstStr, sizeof(dstStr), consume_last, {}); 
-            if (!r) return r;
-            char *pEnd = dstStr;
-            dstVar = strtoul(dstStr, &pEnd, 10);
-            if (pEnd == dstStr)
-            {
-                return ExpectedResult(std::unexpected(::Err{"failed to convert"}));
-            }
-            if (cfg.min != cfg.max)
-            {
-                if (dstVar < cfg.min || dstVar > cfg.max)
-                    return ExpectedResult(std::unexpected(::Err{"failed validation"}));
-            }
-            return r;
-        } 
-    };
-
     template<size_t N>
     inline std::string_view to_sv(const uint8_t (&arr)[N])
     {
         return {(const char*)std::begin(arr), (const char*)std::end(arr) - 1};
     }
 
+#ifndef NRF_UART_HOST
     C4001::C4001(const struct device *pUART):
         uart::Channel(pUART)
     {
     }
+#endif
+
+    C4001::C4001(uart::Transport &t):
+        uart::Channel(t)
+    {
+    }
 
     C4001::ExpectedResult C4001::Init()
     {
@@ -107,6 +45,75 @@ namespace dfr
         return ReloadConfig();
     }
 
+    C4001::ExpectedResult C4001::ReadFrame()
+    {
+        using namespace uart::primitives;
+        auto kind = find_any_str({}, *this, "$DFHPD,", "$DFDMD,");
+        if (!kind)
+            return std::unexpected(Err{kind.error(), "ReadFrame.Find"});
+        if (kind->v == 0)
+        {
+            uint8_t presence = 0;
+            read_uint8_from_str_t readPresence{presence, ','};
+            readPresence.cfg = {.min = 0, .max = 1};
+            TRY_UART_COMM(read_any(*this, readPresence), "ReadFrame.Presence");
+            m_Presence.m_Presence = presence != 0;
+            Publish({AppMode::Presence, m_Presence, m_Target});
+            Trace(uart::trace::Event::StrDataFrame, uint8_t(0), presence);
+        }else
+        {
+            TargetResult t;
+            char unused[8];
+            read_uint8_from_str_t readCount{t.m_Count, ','};
+            read_float_from_str_t readRange{t.m_Range, ','};
+            read_float_from_str_t readSpeed{t.m_Speed, ','};
+            read_float_from_str_t readEnergy{t.m_Energy, ','};
+            TRY_UART_COMM(read_any(*this, readCount, read_until_t{unused, ','}, readRange, readSpeed, readEnergy), "ReadFrame.Target");
+            m_Target = t;
+            Publish({AppMode::SpeedDistance, m_Presence, m_Target});
+            Trace(uart::trace::Event::StrDataFrame, uint8_t(1), t.m_Count);
+        }
+        //the rest of the line carries nothing
+        TRY_UART_COMM(find_bytes(*this, "\n"), "ReadFrame.EOL");
+        return std::ref(*this);
+    }
+
+    C4001::ExpectedResult C4001::TryReadSingleFrame(int attempts)
+    {
+        if (m_ContinuousRead)
+            return TryReadFrame(attempts);
+        RxBlock _RxBlock(*this);
+        return TryReadFrame(attempts);
+    }
+
+    C4001::ExpectedResult C4001::TryReadFrame(int attempts)
+    {
+        for(int i = 0; i < attempts; ++i)
+        {
+            if (auto r = ReadFrame(); r)
+                return r;
+            else
+            {
+                Trace(uart::trace::Event::StrDataFrameErr, uint8_t(m_AppMode));
+                if ((i + 1) == attempts)
+                    return r;
+            }
+        }
+        return std::ref(*this);
+    }
+
+    void C4001::StartContinuousReading()
+    {
+        m_ContinuousRead = true;
+        AllowReadUpTo(m_recvBuf, sizeof(m_recvBuf));
+    }
+
+    void C4001::StopContinuousReading()
+    {
+        StopReading();
+        m_ContinuousRead = false;
+    }
+
     auto C4001::GetConfigurator() -> Configurator
     {
         return Configurator{*this};
@@ -307,6 +314,7 @@ namespace dfr
         if (!m_CtrResult) return m_CtrResult;
         TRY_UART_CFG(m_C.SendCmdNoResp(to_sv(kCmdSetRunApp), to_sv(kCmdAppModePresence)), "");
         k_msleep(500);
+        m_C.m_AppMode = AppMode::Presence;
         return std::ref(*this);
     }
 
@@ -315,6 +323,7 @@ namespace dfr
         if (!m_CtrResult) return m_CtrResult;
         TRY_UART_CFG(m_C.SendCmdNoResp(to_sv(kCmdSetRunApp), to_sv(kCmdAppModeSpeedDistance)), "");
         k_msleep(500);
+        m_C.m_AppMode = AppMode::SpeedDistance;
         return std::ref(*this);
     }
 
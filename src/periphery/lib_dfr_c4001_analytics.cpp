@@ -0,0 +1,159 @@
+#include <nrf_uart/periphery/lib_dfr_c4001_analytics.h>
+
+namespace dfr
+{
+    bool C4001Analytics::AddBand(Band const& b)
+    {
+        if (m_BandCount == kMaxBands || b.minCm >= b.maxCm)
+            return false;
+        m_Bands[m_BandCount] = b;
+        m_DwellMs[m_BandCount] = 0;
+        ++m_BandCount;
+        return true;
+    }
+
+    void C4001Analytics::ResetCounters()
+    {
+        m_Entries = m_Exits = 0;
+        for(auto &d : m_DwellMs)
+            d = 0;
+    }
+
+    uint32_t C4001Analytics::GetDwellMs(uint8_t band, int64_t nowMs) const
+    {
+        if (band >= m_BandCount)
+            return 0;
+        uint64_t d = m_DwellMs[band];
+        if (band == m_Band)
+            d += uint64_t(nowMs - m_BandSinceMs);
+        return uint32_t(std::min<uint64_t>(d, UINT32_MAX));
+    }
+
+    void C4001Analytics::Emit(Kind k, int64_t nowMs, uint8_t band, Sample const& s, uint32_t dwellMs)
+    {
+        if (m_EventCount == std::size(m_Events))
+            return;
+        Event &ev = m_Events[m_EventCount++];
+        ev = Event{nowMs, k, band, s.rangeCm, s.speedCmS, dwellMs};
+        if (m_pQueue)
+            m_pQueue->Push(ev);
+    }
+
+    void C4001Analytics::EnterBand(uint8_t band, int64_t nowMs, Sample const& s)
+    {
+        if (band == m_Band)
+            return;
+        if (m_Band != kNoBand)
+        {
+            uint32_t dwell = uint32_t(nowMs - m_BandSinceMs);
+            m_DwellMs[m_Band] += dwell;
+            Emit(Kind::BandLeave, nowMs, m_Band, s, dwell);
+        }
+        m_Band = band;
+        m_BandSinceMs = nowMs;
+        if (band != kNoBand)
+            Emit(Kind::BandEnter, nowMs, band, s);
+    }
+
+    void C4001Analytics::UpdateDirection(int64_t nowMs, Sample const& s)
+    {
+        const uint8_t n = std::clamp<uint8_t>(m_Cfg.directionFrames, 1, kHistory);
+        if (m_HistoryCount < n)
+            return;
+        uint8_t approach = 0, retreat = 0;
+        for(uint8_t i = 0; i < n; ++i)
+        {
+            int16_t v = m_History[(m_HistoryHead + kHistory - 1 - i) % kHistory].speedCmS;
+            if (v >= int16_t(m_Cfg.speedCmS))
+                ++approach;
+            else if (v <= -int16_t(m_Cfg.speedCmS))
+                ++retreat;
+        }
+        Direction d = m_Dir;
+        if (approach == n)
+            d = Direction::Approach;
+        else if (retreat == n)
+            d = Direction::Retreat;
+        else if (!approach && !retreat)
+            d = Direction::Stationary;
+        if (d == m_Dir)
+            return;
+        m_Dir = d;
+        Emit(d == Direction::Approach ? Kind::Approach : d == Direction::Retreat ? Kind::Retreat : Kind::Stationary, nowMs, kNoBand, s);
+    }
+
+    void C4001Analytics::EndSession(int64_t nowMs)
+    {
+        EnterBand(kNoBand, nowMs, m_Last);
+        uint32_t length = uint32_t(m_LastSeenMs - m_SessionStartMs);
+        if (m_ApproachFrames > m_RetreatFrames)
+        {
+            ++m_Entries;
+            Emit(Kind::Entry, nowMs, kNoBand, m_Last, length);
+        }else if (m_RetreatFrames > m_ApproachFrames)
+        {
+            ++m_Exits;
+            Emit(Kind::Exit, nowMs, kNoBand, m_Last, length);
+        }
+        m_InSession = false;
+        m_Dir = Direction::Unknown;
+        m_HistoryCount = 0;
+    }
+
+    uint8_t C4001Analytics::Add(C4001::TargetResult const& t, int64_t nowMs)
+    {
+        m_EventCount = 0;
+        if (!t.m_Count)
+        {
+            if (m_InSession && nowMs - m_LastSeenMs >= m_Cfg.lostMs)
+                EndSession(nowMs);
+            return m_EventCount;
+        }
+
+        float speed = m_Cfg.approachIsNegative ? -t.m_Speed : t.m_Speed;
+        Sample s{
+            uint16_t(std::clamp<long>(std::lround(t.m_Range * 100.f), 0, UINT16_MAX)),
+            int16_t(std::clamp<long>(std::lround(speed * 100.f), INT16_MIN, INT16_MAX))
+        };
+        if (m_InSession && nowMs - m_LastSeenMs >= m_Cfg.lostMs)
+            EndSession(nowMs);//a new target after a gap the absent frames didn't report
+        if (!m_InSession)
+        {
+            m_InSession = true;
+            m_SessionStartMs = nowMs;
+            m_ApproachFrames = m_RetreatFrames = 0;
+        }
+        m_LastSeenMs = nowMs;
+        m_Last = s;
+
+        m_History[m_HistoryHead] = s;
+        m_HistoryHead = (m_HistoryHead + 1) % kHistory;
+        if (m_HistoryCount < kHistory)
+            ++m_HistoryCount;
+        if (s.speedCmS >= int16_t(m_Cfg.speedCmS))
+            ++m_ApproachFrames;
+        else if (s.speedCmS <= -int16_t(m_Cfg.speedCmS))
+            ++m_RetreatFrames;
+
+        UpdateDirection(nowMs, s);
+        uint8_t band = kNoBand;
+        for(uint8_t i = 0; i < m_BandCount; ++i)
+            if (s.rangeCm >= m_Bands[i].minCm && s.rangeCm < m_Bands[i].maxCm)
+            {
+                band = i;
+                break;
+            }
+        EnterBand(band, nowMs, s);
+        return m_EventCount;
+    }
+
+    uint8_t C4001Analytics::Add(C4001::frame_snapshot_t const& f)
+    {
+        if (f.value.m_Mode != C4001::AppMode::SpeedDistance)
+        {
+            m_EventCount = 0;
+            return 0;
+        }
+        return Add(f.value.m_Target, f.uptimeMs);
+    }
+}
@@ -0,0 +1,329 @@
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <nrf_uart/periphery/lib_dfr_c4001_emu.h>
+
+namespace dfr
+{
+    namespace
+    {
+        template<size_t N>
+        inline std::string_view to_sv(const uint8_t (&arr)[N])
+        {
+            return {(const char*)std::begin(arr), (const char*)std::end(arr) - 1};
+        }
+
+        int32_t to_milli(float v)
+        {
+            return int32_t(v * 1000.f + (v < 0 ? -0.5f : 0.5f));
+        }
+
+        //parses a decimal token into thousandths
+        bool parse_milli(std::string_view tok, int32_t &dst)
+        {
+            char buf[16];
+            if (tok.empty() || tok.size() >= sizeof(buf))
+                return false;
+            std::memcpy(buf, tok.data(), tok.size());
+            buf[tok.size()] = 0;
+            char *pEnd = buf;
+            float v = strtof(buf, &pEnd);
+            if (pEnd != buf + tok.size())
+                return false;
+            dst = to_milli(v);
+            return true;
+        }
+
+        struct LineWriter
+        {
+            char *p;
+            size_t cap;
+            size_t len = 0;
+
+            void put(std::string_view s)
+            {
+                size_t n = std::min(s.size(), cap - len);
+                std::memcpy(p + len, s.data(), n);
+                len += n;
+            }
+            void put_int(int32_t v)
+            {
+                int n = snprintf(p + len, cap - len, "%d", (int)v);
+                if (n > 0) len = std::min(cap, len + n);
+            }
+            void put_milli(int32_t v)
+            {
+                uint32_t a = v < 0 ? uint32_t(-v) : uint32_t(v);
+                int n = snprintf(p + len, cap - len, "%s%u.%03u", v < 0 ? "-" : "", unsigned(a / 1000), unsigned(a % 1000));
+                if (n > 0) len = std::min(cap, len + n);
+            }
+            std::string_view sv() const { return {p, len}; }
+        };
+    }
+
+    /**********************************************************************/
+    /* C4001Emu                                                           */
+    /**********************************************************************/
+    C4001Emu::C4001Emu(uint32_t seed):
+        m_Out(seed)
+    {
+        ResetConfiguration();
+    }
+
+    void C4001Emu::ResetConfiguration()
+    {
+        m_RangeFrom = 600;
+        m_RangeTo = 25000;
+        m_TrigRange = 6000;
+        m_Inhibit = 1000;
+        m_DetectLatency = 100;
+        m_ClearLatency = 1000;
+        m_SensitivityHold = 7;
+        m_SensitivityTrig = 7;
+    }
+
+    void C4001Emu::SetTarget(C4001::TargetResult const& t)
+    {
+        m_TargetCount = t.m_Count;
+        m_TargetRange = to_milli(t.m_Range);
+        m_TargetSpeed = to_milli(t.m_Speed);
+        m_TargetEnergy = to_milli(t.m_Energy);
+    }
+
+    void C4001Emu::OnTx(uart::MemoryTransport &t, const uint8_t *pData, size_t len)
+    {
+        m_Now = k_uptime_get();
+        for(size_t i = 0; i < len; ++i)
+        {
+            char c = char(pData[i]);
+            if (c == '\r')
+                continue;
+            if (c == '\n')
+            {
+                if (!m_LineOverflow)
+                    HandleLine({m_Line, m_LineLen});
+                m_LineLen = 0;
+                m_LineOverflow = false;
+                continue;
+            }
+            if (m_LineLen == sizeof(m_Line))
+            {
+                if (!m_LineOverflow)
+                    ++m_Stats.rxOverflow;
+                m_LineOverflow = true;
+                continue;
+            }
+            m_Line[m_LineLen++] = c;
+        }
+    }
+
+    void C4001Emu::OnPoll(uart::MemoryTransport &t)
+    {
+        m_Now = k_uptime_get();
+        bool active = m_Running && m_Now >= m_SilentUntil;
+        m_Stream.Run(m_Out, m_Now, active, [&](int64_t due){ QueueDataLine(due); });
+        m_Out.Deliver(t, m_Now);
+    }
+
+    void C4001Emu::Respond(std::string_view line)
+    {
+        if (m_DropResp)
+            return;
+        char buf[uart::emu::Outbox::kMaxFrame];
+        LineWriter w{buf, sizeof(buf) - 2};
+        w.put(line);
+        buf[w.len++] = '\r';
+        buf[w.len++] = '\n';
+        m_Out.Queue(m_RespDue, (const uint8_t*)buf, w.len);
+    }
+
+    void C4001Emu::Done(bool ok)
+    {
+        if (!ok)
+            ++m_Stats.errors;
+        Respond(ok ? "Done" : "Error");
+    }
+
+    void C4001Emu::HandleLine(std::string_view line)
+    {
+        if (m_Now < m_SilentUntil)
+            return;//restarting
+        while(!line.empty() && line.back() == ' ')
+            line.remove_suffix(1);
+        if (line.empty())
+            return;
+        ++m_Stats.commands;
+
+        auto const& f = m_Out.GetFaults();
+        m_RespDue = m_Now + f.respDelay + m_Out.Jitter(f.respJitter);
+        m_DropResp = m_Out.Chance(f.dropResp);
+        if (m_DropResp)
+            ++m_Stats.droppedResp;
+
+        std::string_view cmd;
+        std::string_view args[kMaxArgs];
+        size_t argc = 0;
+        bool tooManyArgs = false;
+        for(std::string_view rest = line; !rest.empty();)
+        {
+            size_t sp = rest.find(' ');
+            std::string_view tok = rest.substr(0, sp);
+            rest = sp == std::string_view::npos ? std::string_view{} : rest.substr(sp + 1);
+            if (tok.empty())
+                continue;
+            if (cmd.empty())
+                cmd = tok;
+            else if (argc < kMaxArgs)
+                args[argc++] = tok;
+            else
+                tooManyArgs = true;
+        }
+
+        Respond(line);//echo
+        if (tooManyArgs)
+        {
+            Done(false);
+            return;
+        }
+
+        char buf[uart::emu::Outbox::kMaxFrame - 2];
+        LineWriter w{buf, sizeof(buf)};
+        auto response = [&](auto&&... milli) {
+            w.put("Response");
+            ((w.put(" "), w.put_milli(milli)), ...);
+            Respond(w.sv());
+            Done(true);
+        };
+        //settings can only change while the sensor is stopped
+        auto set1 = [&](int32_t &a, int32_t min, int32_t max) {
+            int32_t va;
+            bool ok = !m_Running && argc == 1 && parse_milli(args[0], va) && va >= min && va <= max;
+            if (ok) a = va;
+            Done(ok);
+        };
+
+        if (cmd == to_sv(C4001::kCmdSensorStop))
+        {
+            m_Running = false;
+            Done(true);
+        }else if (cmd == to_sv(C4001::kCmdSensorStart))
+        {
+            m_Running = true;
+            Done(true);
+        }else if (cmd == to_sv(C4001::kCmdGetHWVersion))
+        {
+            w.put("HardwareVersion:");
+            w.put(m_HWVersion);
+            Respond(w.sv());
+            Done(true);
+        }else if (cmd == to_sv(C4001::kCmdGetSWVersion))
+        {
+            w.put("SoftwareVersion:");
+            w.put(m_SWVersion);
+            Respond(w.sv());
+            Done(true);
+        }else if (cmd == to_sv(C4001::kCmdGetRange))
+            response(m_RangeFrom, m_RangeTo);
+        else if (cmd == to_sv(C4001::kCmdGetTrigRange))
+            response(m_TrigRange);
+        else if (cmd == to_sv(C4001::kCmdGetInhibit))
+            response(m_Inhibit);
+        else if (cmd == to_sv(C4001::kCmdGetLatency))
+            response(m_DetectLatency, m_ClearLatency);
+        else if (cmd == to_sv(C4001::kCmdGetSensitivity))
+        {
+            w.put("Response ");
+            w.put_int(m_SensitivityHold);
+            w.put(" ");
+            w.put_int(m_SensitivityTrig);
+            Respond(w.sv());
+            Done(true);
+        }
+        else if (cmd == to_sv(C4001::kCmdSetRange))
+        {
+            int32_t from, to;
+            bool ok = !m_Running && argc == 2 && parse_milli(args[0], from) && parse_milli(args[1], to)
+                && from >= 600 && from <= to && to <= 25000;
+            if (ok) { m_RangeFrom = from; m_RangeTo = to; }
+            Done(ok);
+        }
+        else if (cmd == to_sv(C4001::kCmdSetTrigRange))
+            set1(m_TrigRange, 600, 25000);
+        else if (cmd == to_sv(C4001::kCmdSetInhibit))
+            set1(m_Inhibit, 100, 255000);
+        else if (cmd == to_sv(C4001::kCmdSetLatency))
+        {
+            int32_t detect, clear;
+            bool ok = !m_Running && argc == 2 && parse_milli(args[0], detect) && parse_milli(args[1], clear)
+                && detect >= 0 && detect <= 100000 && clear >= 0 && clear <= 1500000;
+            if (ok) { m_DetectLatency = detect; m_ClearLatency = clear; }
+            Done(ok);
+        }
+        else if (cmd == to_sv(C4001::kCmdSetSensitivity))
+        {
+            //'255' keeps the current value
+            int32_t hold, trig;
+            bool ok = !m_Running && argc == 2 && parse_milli(args[0], hold) && parse_milli(args[1], trig);
+            hold /= 1000;
+            trig /= 1000;
+            ok = ok && (hold <= 9 || hold == 255) && (trig <= 9 || trig == 255) && hold >= 0 && trig >= 0;
+            if (ok)
+            {
+                if (hold != 255) m_SensitivityHold = hold;
+                if (trig != 255) m_SensitivityTrig = trig;
+            }
+            Done(ok);
+        }
+        else if (cmd == to_sv(C4001::kCmdSaveConfig))
+            Done(!m_Running);
+        else if (cmd == to_sv(C4001::kCmdResetConfig))
+        {
+            if (!m_Running)
+                ResetConfiguration();
+            Done(!m_Running);
+        }
+        else if (cmd == to_sv(C4001::kCmdRestart) || cmd == to_sv(C4001::kCmdSetRunApp))
+        {
+            //no final status: the module reboots
+            if (cmd == to_sv(C4001::kCmdSetRunApp))
+            {
+                if (argc != 1 || (args[0] != to_sv(C4001::kCmdAppModePresence) && args[0] != to_sv(C4001::kCmdAppModeSpeedDistance)))
+                {
+                    Done(false);
+                    return;
+                }
+                m_AppMode = args[0] == to_sv(C4001::kCmdAppModePresence) ? AppMode::Presence : AppMode::SpeedDistance;
+            }
+            m_Running = true;
+            m_SilentUntil = m_Now + m_RestartTime;
+        }
+        else
+            Done(false);
+    }
+
+    void C4001Emu::QueueDataLine(int64_t due)
+    {
+        char buf[uart::emu::Outbox::kMaxFrame];
+        LineWriter w{buf, sizeof(buf)};
+        if (m_AppMode == AppMode::Presence)
+        {
+            w.put("$DFHPD,");
+            w.put_int(m_Presence);
+            w.put(", , , *\r\n");
+        }else
+        {
+            w.put("$DFDMD,");
+            w.put_int(m_TargetCount);
+            w.put(",0,");
+            w.put_milli(m_TargetRange);
+            w.put(",");
+            w.put_milli(m_TargetSpeed);
+            w.put(",");
+            w.put_milli(m_TargetEnergy);
+            w.put(", , *\r\n");
+        }
+        if (m_Out.Queue(due, (const uint8_t*)buf, w.len))
+            ++m_Stats.dataLines;
+    }
+}
@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <cstring>
 #include <nrf_uart/periphery/lib_ld2412.hpp>
+#include <nrf_uart/periphery/lib_ld2412_stats.hpp>
 
 #define DBG_UART Channel::DbgNow _dbg_uart{this}; 
 #define DBG_ME DbgNow _dbg_me{this}; 
@@ -18,9 +19,10 @@
     {\
         if (retry) \
         {\
-            if (m_dbg) printk("Failed on " #f "\n");\
+            if constexpr (uart::kDebugLevel >= uart::DebugLevel::Commands) { printk("Failed on " #f "\n"); }\
             continue;\
         }\
+        Trace(uart::trace::Event::CmdFailed, uint16_t(cmd));\
         return to_cmd_result(std::move(r), location, ec);\
     }
 
@@ -52,6 +54,10 @@ namespace hlk{
             case ErrorCode::FactoryResetFailed: return "FactoryResetFailed";
             case ErrorCode::BTFailed: return "BTFailed";
             case ErrorCode::WrongState: return "WrongState";
+            case ErrorCode::Calibration_NotEnoughData: return "Calibration_NotEnoughData";
+            case ErrorCode::BaudRate_NotSupported: return "BaudRate_NotSupported";
+            case ErrorCode::BaudRate_Failed: return "BaudRate_Failed";
+            case ErrorCode::BaudRate_LinkLost: return "BaudRate_LinkLost";
         }
         return "unknown";
     }
@@ -132,11 +138,12 @@ namespace hlk{
     {
         constexpr const size_t arg_size = (uart::primitives::uart_sizeof<std::remove_cvref_t<T>>() + ...);
         LD2412_TRY_UART_COMM(uart::primitives::match_bytes(*this, kFrameHeader), "RecvFrameV2", ErrorCode::RecvFrame_Malformed);
-        if (m_dbg) printk("RecvFrameV2: matched header\n"); 
+        if constexpr (uart::kDebugLevel >= uart::DebugLevel::Frames) { printk("RecvFrameV2: matched header\n"); }
         uint16_t len;
         LD2412_TRY_UART_COMM(uart::primitives::read_into(*this, len), "RecvFrameV2", ErrorCode::RecvFrame_Malformed);
-        if (m_dbg) printk("RecvFrameV2: len: %d\n", len);
-        if (arg_size > len)
+        Trace(uart::trace::Event::FrameLen, len);
+        if constexpr (uart::kDebugLevel >= uart::DebugLevel::Frames) { printk("RecvFrameV2: len: %d\n", len); }
+        if (arg_size > len || len > kMaxAckLen)
             return std::unexpected(Err{{}, "RecvFrameV2 len invalid", ErrorCode::RecvFrame_Malformed}); 
 
         LD2412_TRY_UART_COMM(uart::primitives::read_any_limited(*this, len, std::forward<T>(args)...), "RecvFrameV2", ErrorCode::RecvFrame_Malformed);
@@ -144,9 +151,10 @@ namespace hlk{
         {
             LD2412_TRY_UART_COMM(uart::primitives::skip_bytes(*this, len), "RecvFrameV2", ErrorCode::RecvFrame_Malformed);
         }
-        if (m_dbg) printk("RecvFrameV2: mathcing footer\n");
+        if constexpr (uart::kDebugLevel >= uart::DebugLevel::Frames) { printk("RecvFrameV2: mathcing footer\n"); }
         LD2412_TRY_UART_COMM(uart::primitives::match_bytes(*this, kFrameFooter), "RecvFrameV2", ErrorCode::RecvFrame_Malformed);
-        if (m_dbg) printk("RecvFrameV2: matched footer\n");
+        Trace(uart::trace::Event::FrameFooter);
+        if constexpr (uart::kDebugLevel >= uart::DebugLevel::Frames) { printk("RecvFrameV2: matched footer\n"); }
         return std::ref(*this);
     }
 
@@ -156,8 +164,11 @@ namespace hlk{
         static_assert(sizeof(CmdT) == 2, "must be 2 bytes");
         if (GetDefaultWait() < kDefaultWait)
             SetDefaultWait(kDefaultWait);
-        if (m_dbg)
+        Trace(uart::trace::Event::CmdSend, uint16_t(cmd));
+        if constexpr (uart::kDebugLevel >= uart::DebugLevel::Commands)
+        {
             printk("SendCommandV2 %x\n", (int)cmd);
+        }
         uint16_t status;
         auto SendFrameExpandArgs = [&]<size_t...idx>(std::index_sequence<idx...>){
             return SendFrame(cmd, std::get<idx>(sendArgs)...);
@@ -167,7 +178,8 @@ namespace hlk{
                 uart::primitives::match_t{uint16_t(cmd | 0x100)}, 
                 status, 
                 uart::primitives::callback_t{[&]()->Channel::ExpectedResult{
-                    if (m_dbg) printk("Recv frame resp. Status %d\n", status);
+                    Trace(uart::trace::Event::CmdStatus, uint16_t(cmd), status);
+                    if constexpr (uart::kDebugLevel >= uart::DebugLevel::Commands) { printk("Recv frame resp. Status %d\n", status); }
                     if (status != 0)
                         return std::unexpected(::Err{"SendCommandV2 status", status});
                     return std::ref((Channel&)*this);
@@ -175,32 +187,43 @@ namespace hlk{
                 std::get<idx>(recvArgs)...);
         };
 
+        auto probe = m_CmdStats.Start(uint16_t(cmd));
         constexpr int kMaxRetry = 1;
         for(int retry=kMaxRetry; retry >= 0; --retry)
         {
             if (retry != kMaxRetry)
             {
-                if (m_dbg) printk("Sending command %x retry: %d\n", uint16_t(cmd), (kMaxRetry - retry));
+                probe.Retry();
+                Trace(uart::trace::Event::CmdRetry, uint16_t(cmd), uint8_t(kMaxRetry - retry));
+                if constexpr (uart::kDebugLevel >= uart::DebugLevel::Commands) { printk("Sending command %x retry: %d\n", uint16_t(cmd), (kMaxRetry - retry)); }
                 k_msleep(kDefaultWait); 
                 (void)Channel::Drain(false).has_value();
             }
             LD2412_TRY_UART_COMM_CMD_WITH_RETRY(SendFrameExpandArgs(std::make_index_sequence<sizeof...(ToSend)>()), "SendCommandV2", ErrorCode::SendCommand_Failed);
-            if (m_dbg) printk("Wait all\n");
+            if constexpr (uart::kDebugLevel >= uart::DebugLevel::Commands) { printk("Wait all\n"); }
             LD2412_TRY_UART_COMM_CMD_WITH_RETRY(WaitAllSent(), "SendCommandV2", ErrorCode::SendCommand_Failed);
-            if (m_dbg) printk("Receiving %d args\n", sizeof...(ToRecv));
+            if constexpr (uart::kDebugLevel >= uart::DebugLevel::Commands) { printk("Receiving %d args\n", sizeof...(ToRecv)); }
             LD2412_TRY_UART_COMM_CMD_WITH_RETRY(RecvFrameExpandArgs(std::make_index_sequence<sizeof...(ToRecv)>()), "SendCommandV2", ErrorCode::SendCommand_Failed);
             break;
         }
+        probe.Success();
         return std::ref(*this);
     }
 
     /**********************************************************************/
     /* LD2412                                                             */
     /**********************************************************************/
+#ifndef NRF_UART_HOST
     LD2412::LD2412(const struct device *pUART):
         uart::Channel(pUART)
     {
     }
+#endif
+
+    LD2412::LD2412(uart::Transport &t):
+        uart::Channel(t)
+    {
+    }
 
     uint8_t LD2412::GetGateFromDistanceCM(int dist, DistanceRes res) 
     {
@@ -276,6 +299,91 @@ namespace hlk{
         return std::ref(*this);
     }
 
+    uint32_t LD2412::to_baudrate(BaudRate r)
+    {
+        switch(r)
+        {
+            case BaudRate::_9600: return 9600;
+            case BaudRate::_19200: return 19200;
+            case BaudRate::_38400: return 38400;
+            case BaudRate::_57600: return 57600;
+            case BaudRate::_115200: return 115200;
+            case BaudRate::_230400: return 230400;
+            case BaudRate::_256000: return 256000;
+            case BaudRate::_460800: return 460800;
+        }
+        return 0;
+    }
+
+    LD2412::ExpectedResult LD2412::VerifyLink(const char *pLocation, ErrorCode ec)
+    {
+        namespace uartp = uart::primitives;
+        LD2412_TRY_UART_COMM(uartp::flush_and_wait(*this, {kRestartTimeout, pLocation}), pLocation, ec);
+        LD2412_TRY_UART_COMM(OpenCommandMode(), pLocation, ec);
+        LD2412_TRY_UART_COMM(UpdateVersion(), pLocation, ec);
+        LD2412_TRY_UART_COMM(CloseCommandMode(), pLocation, ec);
+        if (m_Mode != SystemMode::Simple)
+        {
+            auto rs = ChangeConfiguration().SetSystemMode(m_Mode).EndChange();
+            LD2412_TRY_UART_COMM(rs, pLocation, ec);
+        }
+        return std::ref(*this);
+    }
+
+    LD2412::ExpectedResult LD2412::SetBaudRate(BaudRate rate)
+    {
+        constexpr int64_t kRestartTime = 1000;
+        if (m_ContinuousRead)
+            return std::unexpected(Err{{}, "SetBaudRate", ErrorCode::WrongState});
+        uart::Transport &t = GetTransport();
+        const uint32_t baud = to_baudrate(rate);
+        const uint32_t prev = t.GetBaudrate();
+        //the module must not move where the transport can't follow: try the rate before telling the module
+        if (!baud || t.SetBaudrate(baud) != 0)
+        {
+            (void)t.SetBaudrate(prev);
+            return std::unexpected(Err{{}, "SetBaudRate", ErrorCode::BaudRate_NotSupported});
+        }
+        if (t.SetBaudrate(prev) != 0)
+            return std::unexpected(Err{{}, "SetBaudRate", ErrorCode::BaudRate_NotSupported});
+
+        int64_t restartAt;
+        {
+            RxBlock _RxBlock(*this);
+            SetDefaultWait(kDefaultWait);
+            LD2412_TRY_UART_COMM(OpenCommandMode(), "SetBaudRate", ErrorCode::BaudRate_Failed);
+            LD2412_TRY_UART_COMM(SendCommand(Cmd::SetBaudRate, to_send(uint16_t(rate)), to_recv()), "SetBaudRate", ErrorCode::BaudRate_Failed);
+            //from here on the module has the new rate stored: errors no longer mean it stays at the old one
+            restartAt = k_uptime_get();
+            //the restart ACK still comes at the old rate, so it is read before the transport moves;
+            //without it the module may or may not be restarting, the link check below tells
+            if (!SendCommand(Cmd::Restart, to_send(), to_recv()))
+            {
+                if constexpr (uart::kDebugLevel >= uart::DebugLevel::Commands) { printk("SetBaudRate: no restart ACK\n"); }
+            }
+        }
+        //the module is moving now: a transport that doesn't follow is a link check that failed
+        const bool followed = t.SetBaudrate(baud) == 0;
+        if (int64_t left = restartAt + kRestartTime - k_uptime_get(); left > 0)
+            k_msleep(int32_t(left));
+
+        RxBlock _RxBlock(*this);
+        if (followed && VerifyLink("SetBaudRate", ErrorCode::BaudRate_Failed))
+            return std::ref(*this);
+        const uint32_t fallbacks[] = {prev, prev != kDefaultBaudrate ? kDefaultBaudrate : 0};
+        for(uint32_t fallback : fallbacks)
+        {
+            if (!fallback || fallback == baud || t.SetBaudrate(fallback) != 0)
+                continue;
+            if (VerifyLink("SetBaudRate: fallback", ErrorCode::BaudRate_Failed))
+                return std::unexpected(Err{{}, "SetBaudRate", ErrorCode::BaudRate_Failed});
+        }
+        //the module's rate is unknown, but the new one is stored: the module runs at it after
+        //a restart it has done already or the next one (power cycle) at the latest
+        (void)t.SetBaudrate(baud);
+        return std::unexpected(Err{{}, "SetBaudRate", ErrorCode::BaudRate_LinkLost});
+    }
+
     LD2412::ExpectedResult LD2412::FactoryReset()
     {
         RxBlock _RxBlock(*this);
@@ -342,20 +450,36 @@ namespace hlk{
         SystemMode mode;
         uint8_t check;
         uint16_t reportLen = 0;
+        //published only once the whole frame checks out
+        PresenceResult presence;
+        Engeneering engeneering;
         LD2412_TRY_UART_COMM(uartp::read_until(*this, kDataFrameHeader[0], uart::duration_ms_t(1000), "Searching for header"), "ReadFrameReadFrame", ErrorCode::SimpleData_Malformed);
         LD2412_TRY_UART_COMM(uartp::match_bytes(*this, kDataFrameHeader, "Matching header"), "ReadFrameReadFrame", ErrorCode::SimpleData_Malformed);
         LD2412_TRY_UART_COMM(uartp::read_any(*this, reportLen, mode), "ReadFrameReadFrame", ErrorCode::SimpleData_Malformed);
         LD2412_TRY_UART_COMM(uartp::match_bytes(*this, report_begin, "Matching rep begin"), "ReadFrameReadFrame", ErrorCode::SimpleData_Malformed);
-        LD2412_TRY_UART_COMM(uartp::read_into(*this, m_Presence), "ReadFrameReadFrame", ErrorCode::SimpleData_Malformed);//simple Part of the detection is always there
+        LD2412_TRY_UART_COMM(uartp::read_into(*this, presence), "ReadFrameReadFrame", ErrorCode::SimpleData_Malformed);//simple Part of the detection is always there
         if (mode == SystemMode::Energy)
         {
-            if ((reportLen - 4 - sizeof(m_Presence)) != sizeof(m_Engeneering))
+            if (reportLen != kReportOverhead + sizeof(m_Presence) + sizeof(m_Engeneering))
                 return std::unexpected(Err{{"Wrong engeneering size"}, "ReadFrameReadFrame", ErrorCode::SimpleData_Malformed});
-            LD2412_TRY_UART_COMM(uartp::read_into(*this, m_Engeneering), "ReadFrameReadFrame", ErrorCode::SimpleData_Malformed);
-        }
+            LD2412_TRY_UART_COMM(uartp::read_into(*this, engeneering), "ReadFrameReadFrame", ErrorCode::SimpleData_Malformed);
+        }else if (reportLen != kReportOverhead + sizeof(m_Presence))
+            return std::unexpected(Err{{"Wrong report size"}, "ReadFrameReadFrame", ErrorCode::SimpleData_Malformed});
         LD2412_TRY_UART_COMM(uartp::match_bytes(*this, report_end, "Matching rep end"), "ReadFrameReadFrame", ErrorCode::SimpleData_Malformed);
         LD2412_TRY_UART_COMM(uartp::read_into(*this, check), "ReadFrameReadFrame", ErrorCode::SimpleData_Malformed);//simple Part of the detection is always there
         LD2412_TRY_UART_COMM(uartp::match_bytes(*this, kDataFrameFooter, "Matching footer"), "ReadFrameReadFrame", ErrorCode::SimpleData_Malformed);
+        m_Presence = presence;
+        if (mode == SystemMode::Energy)
+        {
+            m_Engeneering = engeneering;
+            if (m_pEnergyStats)
+                m_pEnergyStats->Add(m_Engeneering);
+        }
+        auto published = m_Latest.Publish({mode, m_Presence, m_Engeneering});
+        if (m_pQueue)
+            m_pQueue->Push(published);
+        Trace(uart::trace::Event::DataFrame, reportLen, uint8_t(mode), uint8_t(m_Presence.m_State));
+        if constexpr (uart::kDebugLevel >= uart::DebugLevel::Frames) { printk("ReadFrame: state=%d len=%d\n", (int)m_Presence.m_State, reportLen); }
         return std::ref(*this);
     }
 
@@ -379,6 +503,19 @@ namespace hlk{
         m_ContinuousRead = false;
     }
 
+    LD2412::ExpectedResult LD2412::SwitchSystemMode(SystemMode mode)
+    {
+        if (mode == m_Mode)
+            return std::ref(*this);
+        const bool continuous = m_ContinuousRead;
+        if (continuous)
+            StopContinuousReading();
+        auto r = ChangeConfiguration().SetSystemMode(mode).EndChange();
+        if (continuous)
+            StartContinuousReading();
+        return r;
+    }
+
     LD2412::ExpectedResult LD2412::TryReadFrame(int attempts, Drain drain)
     {
         if (drain != Drain::No)
@@ -405,6 +542,7 @@ namespace hlk{
             {
                 if (auto r = ReadFrame(); !r)
                 {
+                    Trace(uart::trace::Event::DataFrameErr, uint8_t(m_Mode));
                     if ((i + 1) == attempts)
                         return to_result(std::move(r), "LD2412::TryReadFrame", ec);
                 }else
@@ -428,6 +566,87 @@ namespace hlk{
         return std::ref(*this);
     }
 
+    namespace
+    {
+        uint8_t isqrt(uint16_t v)
+        {
+            uint16_t r = 0;
+            while(uint32_t(r + 1) * (r + 1) <= v)
+                ++r;
+            return uint8_t(r);
+        }
+
+        uint8_t calibrated_threshold(LD2412::energy_stat_t const& s, LD2412::CalibrationConfig const& cfg)
+        {
+            int noise = std::max<int>(s.max, s.avg + cfg.m_Sigmas * isqrt(s.var));
+            return uint8_t(std::clamp<int>(noise + cfg.m_Margin, cfg.m_MinThreshold, cfg.m_MaxThreshold));
+        }
+    }
+
+    LD2412::ExpectedResult LD2412::CalibrateThresholds(CalibrationConfig const& cfg, CalibrationReport *pReport)
+    {
+        if (m_ContinuousRead)
+            return std::unexpected(Err{{}, "CalibrateThresholds", ErrorCode::WrongState});
+
+        const SystemMode prevMode = m_Mode;
+        if (prevMode != SystemMode::Energy)
+        {
+            LD2412_TRY_UART_COMM(ChangeConfiguration().SetSystemMode(SystemMode::Energy).EndChange(), "CalibrateThresholds", ErrorCode::SendCommand_Failed);
+        }
+
+        CalibrationReport report;
+        report.m_PrevMoveThresholds = m_Configuration.m_MoveThreshold;
+        report.m_PrevStillThresholds = m_Configuration.m_StillThreshold;
+
+        LD2412EnergyStats stats(UINT16_MAX);
+        StartContinuousReading();
+        const int64_t end = k_uptime_get() + cfg.m_Duration;
+        while(k_uptime_get() < end && (!cfg.m_MaxFrames || report.m_Frames < cfg.m_MaxFrames) && report.m_Frames < UINT16_MAX - 1)
+        {
+            if (!TryReadFrame(1))
+                ++report.m_ReadFailures;
+            else if (m_Latest.Read().value.m_Mode != SystemMode::Energy)
+            {
+                //a Simple frame still in flight after the switch: m_Engeneering is stale
+                if (report.m_OtherModeFrames < UINT16_MAX)
+                    ++report.m_OtherModeFrames;
+            }else
+            {
+                stats.Add(m_Engeneering);
+                ++report.m_Frames;
+            }
+        }
+        StopContinuousReading();
+
+        auto w = stats.GetCurrent();
+        report.m_Move = w.move;
+        report.m_Still = w.still;
+        const bool enough = report.m_Frames >= std::max<uint16_t>(cfg.m_MinFrames, 1);
+        if (enough)
+        {
+            for(size_t g = 0; g < kGateCount; ++g)
+            {
+                report.m_MoveThresholds[g] = calibrated_threshold(w.move[g], cfg);
+                report.m_StillThresholds[g] = calibrated_threshold(w.still[g], cfg);
+            }
+        }
+
+        ConfigBlock change = ChangeConfiguration();
+        if (prevMode != SystemMode::Energy)
+            change.SetSystemMode(prevMode);
+        if (enough && cfg.m_Apply)
+            change.SetMoveThresholds(report.m_MoveThresholds).SetStillThresholds(report.m_StillThresholds);
+        auto r = change.EndChange();
+        report.m_Applied = r && enough && cfg.m_Apply;
+        if (pReport)
+            *pReport = report;
+        if (!r)
+            return to_result(std::move(r), "CalibrateThresholds", ErrorCode::SendCommand_Failed);
+        if (!enough)
+            return std::unexpected(Err{{}, "CalibrateThresholds", ErrorCode::Calibration_NotEnoughData});
+        return std::ref(*this);
+    }
+
     bool LD2412::IsDynamicBackgroundAnalysisRunning()
     {
         if (m_DynamicBackgroundAnalysis)
@@ -0,0 +1,90 @@
+#include <nrf_uart/periphery/lib_ld2412_background.hpp>
+#include <nrf_uart/periphery/lib_ld2412_gates.hpp>
+#include <algorithm>
+
+namespace hlk{
+    auto LD2412Background::Baseline(Model const& m) -> gate_array_t
+    {
+        gate_array_t r;
+        for(size_t g = 0; g < r.size(); ++g)
+            r[g] = uint8_t((m.base[g] + 128) >> 8);
+        return r;
+    }
+
+    uint16_t LD2412Background::Detect(Model const& m, gate_array_t const& v) const
+    {
+        return gates::above(v, m.thr);
+    }
+
+    void LD2412Background::Init(Model &m, gate_array_t const& v)
+    {
+        for(size_t g = 0; g < v.size(); ++g)
+        {
+            m.base[g] = uint16_t(v[g] << 8);
+            m.dev[g] = 0;
+            m.frozen[g] = 0;
+        }
+    }
+
+    uint16_t LD2412Background::Freeze(Model &m, uint16_t detected) const
+    {
+        //detections not yet absorbed
+        uint16_t blocking = 0;
+        for(size_t g = 0; g < m.frozen.size(); ++g)
+        {
+            if (!(detected & (1 << g)))
+                m.frozen[g] = 0;
+            else if (!m_Cfg.maxFreezeFrames || m.frozen[g] < m_Cfg.maxFreezeFrames)
+            {
+                ++m.frozen[g];
+                blocking |= 1 << g;
+            }
+        }
+        return blocking;
+    }
+
+    void LD2412Background::Learn(Model &m, gate_array_t const& v, uint16_t skip) const
+    {
+        const uint8_t shift = IsWarmedUp() ? m_Cfg.shift : m_Cfg.warmupShift;
+        const uint32_t margin = uint32_t(m_Cfg.margin) << 8;
+        for(size_t g = 0; g < v.size(); ++g)
+        {
+            if (skip & (1 << g))
+                continue;
+            int32_t x = int32_t(v[g]) << 8;
+            int32_t b = m.base[g];
+            int32_t d = m.dev[g];
+            int32_t err = x - b;
+            m.base[g] = uint16_t(b + (err >> shift));
+            m.dev[g] = uint16_t(d + (((err < 0 ? -err : err) - d) >> shift));
+            uint32_t t = m.base[g] + std::max(margin, uint32_t(m_Cfg.devFactor) * m.dev[g]);
+            m.thr[g] = uint8_t(std::min<uint32_t>((t + 128) >> 8, m_Cfg.maxThreshold));
+        }
+    }
+
+    auto LD2412Background::Add(Engeneering const& e) -> Detection
+    {
+        if (!m_Frames)
+        {
+            Init(m_Move, e.m_MoveEnergy);
+            Init(m_Still, e.m_StillEnergy);
+        }
+        Detection det;
+        //thresholds are meaningless until warmed up: nothing detected, nothing frozen
+        if (IsWarmedUp())
+        {
+            det.moveGates = Detect(m_Move, e.m_MoveEnergy);
+            det.stillGates = Detect(m_Still, e.m_StillEnergy);
+        }
+        uint16_t moveHold = Freeze(m_Move, det.moveGates);
+        uint16_t stillHold = Freeze(m_Still, det.stillGates);
+        if (!m_Cfg.freezeAll || !(moveHold | stillHold))
+        {
+            Learn(m_Move, e.m_MoveEnergy, moveHold);
+            Learn(m_Still, e.m_StillEnergy, stillHold);
+        }
+        if (m_Frames < UINT32_MAX)
+            ++m_Frames;
+        return det;
+    }
+}
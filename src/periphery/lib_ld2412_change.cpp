@@ -0,0 +1,70 @@
+#include <nrf_uart/periphery/lib_ld2412_change.hpp>
+
+namespace hlk{
+    namespace
+    {
+        bool has_move(LD2412::TargetState s) { return s == LD2412::TargetState::Move || s == LD2412::TargetState::MoveAndStill; }
+        bool has_still(LD2412::TargetState s) { return s == LD2412::TargetState::Still || s == LD2412::TargetState::MoveAndStill; }
+
+        bool beyond(int a, int b, int hysteresis) { return hysteresis && (a > b ? a - b : b - a) >= hysteresis; }
+    }
+
+    bool LD2412ChangeFilter::Changed(PresenceResult const& p) const
+    {
+        //only the targets the state reports; the other fields are stale
+        if (has_move(p.m_State)
+            && (beyond(p.m_MoveDistance, m_Last.m_MoveDistance, m_Cfg.distanceCm) || beyond(p.m_MoveEnergy, m_Last.m_MoveEnergy, m_Cfg.energy)))
+            return true;
+        if (has_still(p.m_State)
+            && (beyond(p.m_StillDistance, m_Last.m_StillDistance, m_Cfg.distanceCm) || beyond(p.m_StillEnergy, m_Last.m_StillEnergy, m_Cfg.energy)))
+            return true;
+        return false;
+    }
+
+    bool LD2412ChangeFilter::Emit(Reason r, PresenceResult const& p, int64_t nowMs, Event &ev)
+    {
+        ev = Event{nowMs, r, p};
+        m_Last = p;
+        m_HasLast = true;
+        m_LastEventMs = nowMs;
+        if (r == Reason::Transition)
+            m_LastTransitionMs = nowMs;
+        if (r != Reason::Heartbeat)
+            m_LastChangeMs = nowMs;
+        ++m_Stats.events;
+        if (m_pQueue)
+            m_pQueue->Push(ev);
+        return true;
+    }
+
+    bool LD2412ChangeFilter::Add(PresenceResult const& p, int64_t nowMs, Event &ev)
+    {
+        ++m_Stats.frames;
+        if (!m_HasLast)
+            return Emit(Reason::Transition, p, nowMs, ev);
+
+        if (p.m_State != m_Last.m_State)
+        {
+            if (nowMs - m_LastTransitionMs >= m_Cfg.holdMs)
+            {
+                m_Pending = false;
+                return Emit(Reason::Transition, p, nowMs, ev);
+            }
+            m_Pending = true;
+        }else
+        {
+            if (m_Pending)
+            {
+                //flapped back before the hold expired: the consumer never needs to know
+                m_Pending = false;
+                ++m_Stats.suppressedTransitions;
+            }
+            if (Changed(p) && nowMs - m_LastChangeMs >= m_Cfg.minIntervalMs)
+                return Emit(Reason::Change, p, nowMs, ev);
+        }
+
+        if (m_Cfg.heartbeatMs && nowMs - m_LastEventMs >= m_Cfg.heartbeatMs)
+            return Emit(Reason::Heartbeat, m_Pending ? m_Last : p, nowMs, ev);
+        return false;
+    }
+}
@@ -0,0 +1,307 @@
+#include <algorithm>
+#include <cstring>
+#include <nrf_uart/periphery/lib_ld2412_emu.hpp>
+
+namespace hlk{
+    namespace
+    {
+        constexpr uint8_t kReportBegin = 0xaa;
+        constexpr uint8_t kReportEnd = 0x55;
+        constexpr uint16_t kVersionBegin = 0x2412;
+        constexpr uint16_t kStatusOk = 0;
+        constexpr uint16_t kStatusFailed = 1;
+
+        struct FrameWriter
+        {
+            uint8_t *p;
+            size_t len = 0;
+
+            void put(const void *pData, size_t n) { std::memcpy(p + len, pData, n); len += n; }
+            template<class T>
+            void put(T const& v) { put(&v, sizeof(v)); }
+        };
+    }
+
+    /**********************************************************************/
+    /* LD2412Emu                                                          */
+    /**********************************************************************/
+    LD2412Emu::LD2412Emu(uint32_t seed):
+        m_Out(seed)
+    {
+        ResetConfiguration();
+    }
+
+    void LD2412Emu::ResetConfiguration()
+    {
+        m_Configuration = {};
+        m_Configuration.m_Base.m_MaxDistanceGate = LD2412::kMaxGate;
+        m_Configuration.m_Base.m_Duration = 5;
+        m_Configuration.m_MoveThreshold.fill(30);
+        m_Configuration.m_StillThreshold.fill(25);
+        m_DistanceResolution = {};
+        m_Mode = SystemMode::Simple;
+    }
+
+    void LD2412Emu::OnTx(uart::MemoryTransport &t, const uint8_t *pData, size_t len)
+    {
+        constexpr auto &kHeader = LD2412::kFrameHeader;
+        constexpr auto &kFooter = LD2412::kFrameFooter;
+        m_Now = k_uptime_get();
+        if (!LineMatches(t))
+        {
+            m_Stats.rxMalformed += len;
+            return;
+        }
+        while(len)
+        {
+            size_t n = std::min(len, sizeof(m_CmdBuf) - m_CmdLen);
+            std::memcpy(m_CmdBuf + m_CmdLen, pData, n);
+            m_CmdLen += n;
+            pData += n;
+            len -= n;
+
+            //the driver sends header, length, data and footer as separate chunks
+            while(m_CmdLen)
+            {
+                size_t drop = 0;
+                size_t hdr = std::min(m_CmdLen, sizeof(kHeader));
+                if (std::memcmp(m_CmdBuf, kHeader, hdr) != 0)
+                    drop = 1;
+                else if (m_CmdLen < sizeof(kHeader) + 2)
+                    break;
+                else
+                {
+                    uint16_t payloadLen;
+                    std::memcpy(&payloadLen, m_CmdBuf + sizeof(kHeader), 2);
+                    size_t total = sizeof(kHeader) + 2 + payloadLen + sizeof(kFooter);
+                    if (payloadLen < 2 || total > sizeof(m_CmdBuf))
+                        drop = 1;
+                    else if (m_CmdLen < total)
+                        break;
+                    else if (std::memcmp(m_CmdBuf + total - sizeof(kFooter), kFooter, sizeof(kFooter)) != 0)
+                        drop = 1;
+                    else
+                    {
+                        uint16_t cmd;
+                        std::memcpy(&cmd, m_CmdBuf + sizeof(kHeader) + 2, 2);
+                        HandleCommand(Cmd(cmd), m_CmdBuf + sizeof(kHeader) + 4, payloadLen - 2);
+                        drop = total;
+                    }
+                }
+
+                if (drop == 1)
+                    ++m_Stats.rxMalformed;
+                std::memmove(m_CmdBuf, m_CmdBuf + drop, m_CmdLen - drop);
+                m_CmdLen -= drop;
+            }
+        }
+    }
+
+    void LD2412Emu::OnPoll(uart::MemoryTransport &t)
+    {
+        m_Now = k_uptime_get();
+        bool active = !m_CmdMode && m_Now >= m_SilentUntil;
+        m_Stream.Run(m_Out, m_Now, active, [&](int64_t due){ QueueDataFrame(due); });
+        if (!LineMatches(t))
+            m_Out.Clear();//nothing readable reaches the other side
+        else
+            m_Out.Deliver(t, m_Now);
+        //the restart ACK still goes out at the old rate, the module switches after it
+        if (m_RestartBaudrate && !m_Out.size())
+        {
+            m_Baudrate = m_RestartBaudrate;
+            m_RestartBaudrate = 0;
+        }
+    }
+
+    void LD2412Emu::HandleCommand(Cmd c, const uint8_t *pParams, size_t len)
+    {
+        using Base = decltype(m_Configuration.m_Base);
+        using LightSense = decltype(m_Configuration.m_LightSense);
+        if (m_Now < m_SilentUntil)
+            return;//restarting
+        ++m_Stats.commands;
+
+        if (c != Cmd::OpenCmd && !m_CmdMode)
+        {
+            Ack(c, kStatusFailed);
+            return;
+        }
+
+        switch(c)
+        {
+            case Cmd::OpenCmd:
+            {
+                m_CmdMode = true;
+                uint16_t resp[2] = {kProtocolVersion, kBufferSize};
+                Ack(c, kStatusOk, resp, sizeof(resp));
+                return;
+            }
+            case Cmd::CloseCmd:
+                m_CmdMode = false;
+                Ack(c, kStatusOk);
+                return;
+            case Cmd::ReadVer:
+            {
+                uint8_t resp[2 + sizeof(m_Version)];
+                std::memcpy(resp, &kVersionBegin, 2);
+                std::memcpy(resp + 2, &m_Version, sizeof(m_Version));
+                Ack(c, kStatusOk, resp, sizeof(resp));
+                return;
+            }
+            case Cmd::SetDistanceRes:
+            {
+                if (len < 1)
+                    break;
+                auto r = LD2412::DistanceRes(pParams[0]);
+                if (r != LD2412::DistanceRes::_0_75 && r != LD2412::DistanceRes::_0_50 && r != LD2412::DistanceRes::_0_20)
+                    break;
+                m_DistanceResolution.m_Res = r;
+                Ack(c, kStatusOk);
+                return;
+            }
+            case Cmd::GetDistanceRes:
+                Ack(c, kStatusOk, &m_DistanceResolution, sizeof(m_DistanceResolution));
+                return;
+            case Cmd::WriteBaseParams:
+            {
+                Base b;
+                if (len < sizeof(b))
+                    break;
+                std::memcpy(&b, pParams, sizeof(b));
+                if (b.m_MinDistanceGate > b.m_MaxDistanceGate || b.m_MaxDistanceGate > LD2412::kMaxGate)
+                    break;
+                m_Configuration.m_Base = b;
+                Ack(c, kStatusOk);
+                return;
+            }
+            case Cmd::ReadBaseParams:
+                Ack(c, kStatusOk, &m_Configuration.m_Base, sizeof(Base));
+                return;
+            case Cmd::EnterEngMode:
+                m_Mode = SystemMode::Energy;
+                Ack(c, kStatusOk);
+                return;
+            case Cmd::LeaveEngMode:
+                m_Mode = SystemMode::Simple;
+                Ack(c, kStatusOk);
+                return;
+            case Cmd::SetMoveSensitivity:
+            case Cmd::SetStillSensitivity:
+            {
+                auto &dst = c == Cmd::SetMoveSensitivity ? m_Configuration.m_MoveThreshold : m_Configuration.m_StillThreshold;
+                if (len < sizeof(dst))
+                    break;
+                std::memcpy(dst.data(), pParams, sizeof(dst));
+                Ack(c, kStatusOk);
+                return;
+            }
+            case Cmd::GetMoveSensitivity:
+                Ack(c, kStatusOk, m_Configuration.m_MoveThreshold.data(), sizeof(m_Configuration.m_MoveThreshold));
+                return;
+            case Cmd::GetStillSensitivity:
+                Ack(c, kStatusOk, m_Configuration.m_StillThreshold.data(), sizeof(m_Configuration.m_StillThreshold));
+                return;
+            case Cmd::RunDynamicBackgroundAnalysis:
+                m_BackgroundAnalysisEnd = m_Now + m_BackgroundAnalysisTime;
+                Ack(c, kStatusOk);
+                return;
+            case Cmd::QuearyDynamicBackgroundAnalysis:
+            {
+                uint16_t active = m_Now < m_BackgroundAnalysisEnd;
+                Ack(c, kStatusOk, &active, sizeof(active));
+                return;
+            }
+            case Cmd::SetLightSensitivity:
+            {
+                LightSense l;
+                if (len < sizeof(l))
+                    break;
+                std::memcpy(&l, pParams, sizeof(l));
+                m_Configuration.m_LightSense = l;
+                Ack(c, kStatusOk);
+                return;
+            }
+            case Cmd::GetLightSensitivity:
+                Ack(c, kStatusOk, &m_Configuration.m_LightSense, sizeof(LightSense));
+                return;
+            case Cmd::FactoryReset:
+                ResetConfiguration();
+                Ack(c, kStatusOk);
+                return;
+            case Cmd::Restart:
+                Ack(c, kStatusOk);
+                m_CmdMode = false;
+                m_Mode = SystemMode::Simple;
+                m_SilentUntil = m_Now + m_RestartTime;
+                m_RestartBaudrate = m_PendingBaudrate;
+                m_PendingBaudrate = 0;
+                return;
+            case Cmd::SetBaudRate:
+            {
+                if (len < 2)
+                    break;
+                uint16_t v;
+                std::memcpy(&v, pParams, 2);
+                uint32_t baud = LD2412::to_baudrate(LD2412::BaudRate(v));
+                if (!baud)
+                    break;
+                m_PendingBaudrate = baud;
+                Ack(c, kStatusOk);
+                return;
+            }
+            case Cmd::SwitchBluetooth:
+                if (len < 2)
+                    break;
+                m_Bluetooth = pParams[0] != 0;
+                Ack(c, kStatusOk);
+                return;
+            case Cmd::GetMAC:
+                Ack(c, kStatusOk, m_MAC.data(), m_MAC.size());
+                return;
+        }
+        Ack(c, kStatusFailed);
+    }
+
+    void LD2412Emu::Ack(Cmd c, uint16_t status, const void *pPayload, size_t len)
+    {
+        auto const& f = m_Out.GetFaults();
+        if (m_Out.Chance(f.dropResp))
+        {
+            ++m_Stats.droppedAcks;
+            return;
+        }
+        uint8_t buf[uart::emu::Outbox::kMaxFrame];
+        FrameWriter w{buf};
+        w.put(LD2412::kFrameHeader, sizeof(LD2412::kFrameHeader));
+        w.put(uint16_t(4 + len));
+        w.put(uint16_t(uint16_t(c) | 0x100));
+        w.put(status);
+        w.put(pPayload, len);
+        w.put(LD2412::kFrameFooter, sizeof(LD2412::kFrameFooter));
+
+        if (m_Out.Queue(m_Now + f.respDelay + m_Out.Jitter(f.respJitter), buf, w.len))
+            ++m_Stats.acks;
+    }
+
+    void LD2412Emu::QueueDataFrame(int64_t due)
+    {
+        uint8_t buf[uart::emu::Outbox::kMaxFrame];
+        FrameWriter w{buf};
+        uint16_t len = 1 + 1 + sizeof(m_Presence) + 1 + 1;
+        if (m_Mode == SystemMode::Energy)
+            len += sizeof(m_Engeneering);
+        w.put(LD2412::kDataFrameHeader, sizeof(LD2412::kDataFrameHeader));
+        w.put(len);
+        w.put(m_Mode);
+        w.put(kReportBegin);
+        w.put(m_Presence);
+        if (m_Mode == SystemMode::Energy)
+            w.put(m_Engeneering);
+        w.put(kReportEnd);
+        w.put(uint8_t(0));//check
+        w.put(LD2412::kDataFrameFooter, sizeof(LD2412::kDataFrameFooter));
+        if (m_Out.Queue(due, buf, w.len))
+            ++m_Stats.dataFrames;
+    }
+}
@@ -0,0 +1,287 @@
+#include <nrf_uart/periphery/lib_ld2412_flash_log.hpp>
+#include <cstring>
+#include <algorithm>
+
+namespace hlk{
+    namespace
+    {
+        constexpr uint32_t kTokenUnit = 60000;//tokens are kept in record/ms * ratePerMinute units
+
+        size_t put_varint(uint8_t *p, uint32_t v)
+        {
+            size_t n = 0;
+            do
+            {
+                uint8_t b = v & 0x7f;
+                v >>= 7;
+                p[n++] = b | (v ? 0x80 : 0);
+            }while(v);
+            return n;
+        }
+
+        bool get_varint(const uint8_t *&p, const uint8_t *pEnd, uint32_t &v)
+        {
+            v = 0;
+            for(int shift = 0; shift < 35 && p < pEnd; shift += 7)
+            {
+                uint8_t b = *p++;
+                v |= uint32_t(b & 0x7f) << shift;
+                if (!(b & 0x80))
+                    return true;
+            }
+            return false;
+        }
+
+        template<class T>
+        void put_le(uint8_t *p, T v)
+        {
+            for(size_t i = 0; i < sizeof(T); ++i)
+                p[i] = uint8_t(v >> (8 * i));
+        }
+
+        template<class T>
+        T get_le(const uint8_t *p)
+        {
+            T v = 0;
+            for(size_t i = 0; i < sizeof(T); ++i)
+                v |= T(p[i]) << (8 * i);
+            return v;
+        }
+
+        size_t payload_size(LD2412FlashLog::RecordType t)
+        {
+            switch(t)
+            {
+                case LD2412FlashLog::RecordType::Transition: return sizeof(LD2412::PresenceResult);
+                case LD2412FlashLog::RecordType::Engineering: return sizeof(LD2412::Engeneering);
+            }
+            return 0;
+        }
+
+        //FCB keeps a length (1-2 bytes) and a CRC byte per entry, each rounded to the write alignment
+        uint32_t fcb_overhead(fcb const& f, size_t len)
+        {
+            uint32_t align = std::max<uint32_t>(f.f_align, 1);
+            auto round = [&](uint32_t v) { return (v + align - 1) / align * align; };
+            return round(len < 0x80 ? 1 : 2) + round(1) + (round(len) - len);
+        }
+    }
+
+    LD2412FlashLog::LD2412FlashLog(std::span<uint8_t> batch, std::span<flash_sector> sectors):
+        m_Batch(batch),
+        m_Sectors(sectors)
+    {
+    }
+
+    int LD2412FlashLog::Init(uint8_t flashAreaId, Config const& cfg)
+    {
+        m_Cfg = cfg;
+        m_Ready = false;
+        if (m_Batch.size() <= kBatchHeader)
+            return -EINVAL;
+
+        uint32_t count = m_Sectors.size();
+        if (int r = flash_area_get_sectors(flashAreaId, &count, m_Sectors.data()); r != 0)
+            return r;
+        m_Fcb = {};
+        m_Fcb.f_magic = 0x4c443234;//"LD24"
+        m_Fcb.f_version = kVersion;
+        m_Fcb.f_sector_cnt = uint8_t(count);
+        m_Fcb.f_sectors = m_Sectors.data();
+        if (int r = fcb_init(flashAreaId, &m_Fcb); r != 0)
+            return r;
+        if (m_Fcb.f_align > kMaxWriteAlign)
+            return -ENOTSUP;
+
+        //continue the boot numbering of what is in flash
+        struct Last { uint16_t boot; bool any; } last{0, false};
+        fcb_walk(&m_Fcb, nullptr, [](fcb_entry_ctx *pCtx, void *pArg) -> int {
+            auto &l = *static_cast<Last*>(pArg);
+            uint8_t head[3];
+            if (pCtx->loc.fe_data_len >= sizeof(head)
+                && flash_area_read(pCtx->fap, FCB_ENTRY_FA_DATA_OFF(pCtx->loc), head, sizeof(head)) == 0
+                && head[0] == kVersion)
+            {
+                l.boot = get_le<uint16_t>(head + 1);
+                l.any = true;
+            }
+            return 0;
+        }, &last);
+        m_Boot = last.any ? uint16_t(last.boot + 1) : 0;
+
+        m_Used = 0;
+        m_Dropped = 0;
+        m_Tokens = uint32_t(m_Cfg.burst) * kTokenUnit;
+        m_TokensMs = k_uptime_get();
+        m_Ready = true;
+        return 0;
+    }
+
+    bool LD2412FlashLog::Allow(int64_t nowMs)
+    {
+        const uint32_t cap = uint32_t(m_Cfg.burst) * kTokenUnit;
+        if (nowMs > m_TokensMs)
+        {
+            uint64_t add = uint64_t(nowMs - m_TokensMs) * m_Cfg.ratePerMinute;
+            m_Tokens = uint32_t(std::min<uint64_t>(m_Tokens + add, cap));
+            m_TokensMs = nowMs;
+        }
+        if (m_Tokens < kTokenUnit)
+        {
+            ++m_Stats.dropped;
+            if (m_Dropped < UINT16_MAX)
+                ++m_Dropped;
+            return false;
+        }
+        m_Tokens -= kTokenUnit;
+        return true;
+    }
+
+    bool LD2412FlashLog::Append(RecordType t, const void *pPayload, size_t len, int64_t nowMs)
+    {
+        const size_t need = 1 + 5 + len;
+        if (m_Used && m_Used + need > m_Batch.size())
+            (void)Flush();
+        if (kBatchHeader + need > m_Batch.size())
+            return false;
+        if (!m_Used)
+        {
+            m_Batch[0] = kVersion;
+            put_le<uint16_t>(&m_Batch[1], m_Boot);
+            put_le<uint32_t>(&m_Batch[3], uint32_t(nowMs));
+            put_le<uint16_t>(&m_Batch[7], m_Dropped);
+            m_Dropped = 0;
+            m_Used = kBatchHeader;
+            m_BatchStartMs = m_LastRecordMs = nowMs;
+        }
+        uint8_t *p = m_Batch.data() + m_Used;
+        size_t n = 0;
+        p[n++] = uint8_t(t);
+        n += put_varint(p + n, uint32_t(std::max<int64_t>(nowMs - m_LastRecordMs, 0)));
+        memcpy(p + n, pPayload, len);
+        n += len;
+        m_Used += n;
+        m_LastRecordMs = nowMs;
+        ++m_Stats.records;
+        m_Stats.payloadBytes += n;
+        return true;
+    }
+
+    bool LD2412FlashLog::AddTransition(PresenceResult const& p, int64_t nowMs)
+    {
+        if (!m_Ready || !Allow(nowMs))
+            return false;
+        return Append(RecordType::Transition, &p, sizeof(p), nowMs);
+    }
+
+    bool LD2412FlashLog::AddEngineering(Engeneering const& e, int64_t nowMs)
+    {
+        if (!m_Ready || nowMs - m_LastSnapshotMs < int64_t(m_Cfg.minSnapshotMs))
+            return false;
+        m_LastSnapshotMs = nowMs;//a rate limited snapshot waits for the next interval too
+        if (!Allow(nowMs))
+            return false;
+        return Append(RecordType::Engineering, &e, sizeof(e), nowMs);
+    }
+
+    int LD2412FlashLog::Poll(int64_t nowMs)
+    {
+        if (m_Used && nowMs - m_BatchStartMs >= int64_t(m_Cfg.flushMs))
+            return Flush();
+        return 0;
+    }
+
+    int LD2412FlashLog::Write(const uint8_t *pData, size_t len)
+    {
+        fcb_entry loc;
+        int r = fcb_append(&m_Fcb, uint16_t(len), &loc);
+        if (r == -ENOSPC)
+        {
+            //full: drop the oldest sector
+            if ((r = fcb_rotate(&m_Fcb)) != 0)
+                return r;
+            ++m_Stats.rotations;
+            r = fcb_append(&m_Fcb, uint16_t(len), &loc);
+        }
+        if (r != 0)
+            return r;
+        //flash takes whole write blocks only (4 bytes on nRF): FCB reserved len rounded up to
+        //f_align, the tail goes out zero padded (a type 0 record ends a batch for WalkImpl)
+        const size_t align = std::max<size_t>(m_Fcb.f_align, 1);
+        const size_t body = len / align * align;
+        if (body && (r = flash_area_write(m_Fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc), pData, body)) != 0)
+            return r;
+        if (body != len)
+        {
+            uint8_t tail[kMaxWriteAlign] = {0};//Init checked align fits
+            memcpy(tail, pData + body, len - body);
+            if ((r = flash_area_write(m_Fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc) + body, tail, align)) != 0)
+                return r;
+        }
+        if ((r = fcb_append_finish(&m_Fcb, &loc)) != 0)
+            return r;
+        m_Stats.flashBytes += len + fcb_overhead(m_Fcb, len);
+        ++m_Stats.batches;
+        return 0;
+    }
+
+    int LD2412FlashLog::Flush()
+    {
+        if (!m_Ready || !m_Used)
+            return 0;
+        int r = Write(m_Batch.data(), m_Used);
+        if (r != 0)
+            ++m_Stats.errors;
+        //a batch that can't be written is dropped rather than blocking every later record
+        m_Used = 0;
+        return r;
+    }
+
+    int LD2412FlashLog::Clear()
+    {
+        if (!m_Ready)
+            return -EINVAL;
+        m_Used = 0;
+        return fcb_clear(&m_Fcb);
+    }
+
+    int LD2412FlashLog::WalkImpl(walk_cb_t cb, void *pCtx)
+    {
+        if (!m_Ready)
+            return -EINVAL;
+        if (int r = Flush(); r != 0)
+            return r;
+        struct Walker { LD2412FlashLog *pThis; walk_cb_t cb; void *pCtx; } w{this, cb, pCtx};
+        int r = fcb_walk(&m_Fcb, nullptr, [](fcb_entry_ctx *pEntry, void *pArg) -> int {
+            auto &w = *static_cast<Walker*>(pArg);
+            auto buf = w.pThis->m_Batch;
+            size_t len = std::min<size_t>(pEntry->loc.fe_data_len, buf.size());
+            if (len < kBatchHeader || flash_area_read(pEntry->fap, FCB_ENTRY_FA_DATA_OFF(pEntry->loc), buf.data(), len) != 0)
+                return 0;//unreadable entry: skip it
+            if (buf[0] != kVersion)
+                return 0;
+            Record rec{};
+            rec.boot = get_le<uint16_t>(&buf[1]);
+            rec.uptimeMs = get_le<uint32_t>(&buf[3]);
+            rec.droppedBefore = get_le<uint16_t>(&buf[7]);
+            const uint8_t *p = buf.data() + kBatchHeader;
+            const uint8_t *pEnd = buf.data() + len;
+            while(p < pEnd)
+            {
+                rec.type = RecordType(*p++);
+                uint32_t delta;
+                size_t sz = payload_size(rec.type);
+                if (!sz || !get_varint(p, pEnd, delta) || size_t(pEnd - p) < sz)
+                    break;
+                rec.uptimeMs += delta;
+                memcpy(rec.type == RecordType::Transition ? (void*)&rec.presence : (void*)&rec.engineering, p, sz);
+                p += sz;
+                if (!w.cb(rec, w.pCtx))
+                    return 1;
+                rec.droppedBefore = 0;
+            }
+            return 0;
+        }, &w);
+        return r < 0 ? r : 0;
+    }
+}
@@ -0,0 +1,112 @@
+#include <nrf_uart/periphery/lib_ld2412_history.hpp>
+#include <nrf_uart/periphery/lib_ld2412_gates.hpp>
+
+namespace hlk{
+    namespace
+    {
+        using TargetState = LD2412::TargetState;
+
+        bool has_move(TargetState s) { return s == TargetState::Move || s == TargetState::MoveAndStill; }
+        bool has_still(TargetState s) { return s == TargetState::Still || s == TargetState::MoveAndStill; }
+    }
+
+    LD2412History::LD2412History(std::span<RawSample> raw, std::span<Aggregate> seconds, std::span<Aggregate> minutes)
+    {
+        m_Raw.storage = raw;
+        m_Seconds.storage = seconds;
+        m_Minutes.storage = minutes;
+    }
+
+    void LD2412History::Clear()
+    {
+        m_Raw.Clear();
+        m_Seconds.Clear();
+        m_Minutes.Clear();
+        m_Second = {};
+        m_Minute = {};
+    }
+
+    void LD2412History::Fold(Aggregate &a, PresenceResult const& p, Engeneering const* pEng)
+    {
+        ++a.frames;
+        const bool move = has_move(p.m_State);
+        const bool still = has_still(p.m_State);
+        a.occupied += move || still;
+        a.move += move;
+        a.still += still;
+        if (move)
+        {
+            a.minDistance = std::min(a.minDistance, p.m_MoveDistance);
+            a.maxDistance = std::max(a.maxDistance, p.m_MoveDistance);
+        }
+        if (still)
+        {
+            a.minDistance = std::min(a.minDistance, p.m_StillDistance);
+            a.maxDistance = std::max(a.maxDistance, p.m_StillDistance);
+        }
+        if (pEng)
+        {
+            a.moveMax = gates::max(a.moveMax, pEng->m_MoveEnergy);
+            a.stillMax = gates::max(a.stillMax, pEng->m_StillEnergy);
+        }
+    }
+
+    void LD2412History::Merge(Aggregate &into, Aggregate const& from)
+    {
+        if (!into.frames)
+            into.startS = from.startS;
+        //a minute holds at most ~1200 frames at the module's 20 Hz, far from saturating
+        into.frames += from.frames;
+        into.occupied += from.occupied;
+        into.move += from.move;
+        into.still += from.still;
+        into.minDistance = std::min(into.minDistance, from.minDistance);
+        into.maxDistance = std::max(into.maxDistance, from.maxDistance);
+        into.moveMax = gates::max(into.moveMax, from.moveMax);
+        into.stillMax = gates::max(into.stillMax, from.stillMax);
+    }
+
+    void LD2412History::CloseSecond()
+    {
+        if (!m_Second.frames)
+            return;
+        m_Seconds.Push(m_Second);
+        Merge(m_Minute, m_Second);
+        m_Second = {};
+    }
+
+    void LD2412History::CloseMinute()
+    {
+        if (!m_Minute.frames)
+            return;
+        m_Minutes.Push(m_Minute);
+        m_Minute = {};
+    }
+
+    void LD2412History::Add(PresenceResult const& p, Engeneering const* pEng, int64_t nowMs)
+    {
+        const uint32_t nowS = uint32_t(nowMs / 1000);
+        if (m_Second.frames && nowS != m_Second.startS)
+        {
+            CloseSecond();
+            if (nowS / 60 != m_Minute.startS / 60)
+                CloseMinute();
+        }
+        if (!m_Second.frames)
+            m_Second.startS = nowS;
+
+        RawSample r{uint32_t(nowMs), p, 0, 0};
+        if (pEng)
+        {
+            r.moveMax = gates::max_gate(pEng->m_MoveEnergy).value;
+            r.stillMax = gates::max_gate(pEng->m_StillEnergy).value;
+        }
+        m_Raw.Push(r);
+        Fold(m_Second, p, pEng);
+    }
+
+    void LD2412History::Add(LD2412::frame_snapshot_t const& f)
+    {
+        Add(f.value.m_Presence, f.value.m_Mode == LD2412::SystemMode::Energy ? &f.value.m_Engeneering : nullptr, f.uptimeMs);
+    }
+}
@@ -0,0 +1,138 @@
+#include <nrf_uart/periphery/lib_ld2412_mode_policy.hpp>
+
+namespace hlk{
+    namespace
+    {
+        using TargetState = LD2412::TargetState;
+
+        bool has_move(TargetState s) { return s == TargetState::Move || s == TargetState::MoveAndStill; }
+        bool has_still(TargetState s) { return s == TargetState::Still || s == TargetState::MoveAndStill; }
+
+        //a target is reported, but none of them with energy to spare
+        bool ambiguous(LD2412::PresenceResult const& p, uint8_t energy)
+        {
+            if (!has_move(p.m_State) && !has_still(p.m_State))
+                return false;
+            uint8_t e = 0;
+            if (has_move(p.m_State))
+                e = p.m_MoveEnergy;
+            if (has_still(p.m_State))
+                e = std::max(e, p.m_StillEnergy);
+            return e < energy;
+        }
+    }
+
+    void LD2412ModePolicy::Account(int64_t nowMs)
+    {
+        uint64_t dt = uint64_t(std::max<int64_t>(nowMs - m_AccountedMs, 0));
+        if (m_Mode == SystemMode::Energy)
+            m_Stats.energyMs += dt;
+        else
+            m_Stats.simpleMs += dt;
+        m_AccountedMs = std::max(nowMs, m_AccountedMs);
+        //also picks up switches done elsewhere (CalibrateThresholds, ConfigBlock)
+        m_Mode = m_D.GetSystemMode();
+    }
+
+    LD2412ModePolicy::Stats LD2412ModePolicy::GetStats(int64_t nowMs) const
+    {
+        Stats s = m_Stats;
+        uint64_t dt = uint64_t(std::max<int64_t>(nowMs - m_AccountedMs, 0));
+        if (m_Mode == SystemMode::Energy)
+            s.energyMs += dt;
+        else
+            s.simpleMs += dt;
+        return s;
+    }
+
+    void LD2412ModePolicy::ResetStats(int64_t nowMs)
+    {
+        m_Stats = {};
+        m_AccountedMs = nowMs;
+    }
+
+    void LD2412ModePolicy::Trigger(Reason r, int64_t nowMs, int64_t untilMs)
+    {
+        if (nowMs >= m_EnergyUntilMs)
+        {
+            //a new Energy stint: counted once, not on every frame that keeps it going
+            m_Reason = r;
+            ++m_Stats.triggers[size_t(r)];
+        }
+        m_EnergyUntilMs = std::max(m_EnergyUntilMs, untilMs);
+    }
+
+    bool LD2412ModePolicy::Flapping(PresenceResult const& p, int64_t nowMs)
+    {
+        if (p.m_State == m_LastState)
+            return false;
+        m_LastState = p.m_State;
+        m_Transitions[m_TransitionHead] = nowMs;
+        m_TransitionHead = (m_TransitionHead + 1) % kMaxFlapTransitions;
+        if (m_TransitionCount < kMaxFlapTransitions)
+            ++m_TransitionCount;
+
+        const uint8_t n = std::min(m_Cfg.flapTransitions, kMaxFlapTransitions);
+        if (!n || m_TransitionCount < n)
+            return false;
+        //the n-th most recent transition
+        int64_t oldest = m_Transitions[(m_TransitionHead + kMaxFlapTransitions - n) % kMaxFlapTransitions];
+        return nowMs - oldest <= m_Cfg.flapWindowMs;
+    }
+
+    LD2412ModePolicy::ExpectedResult LD2412ModePolicy::Switch(SystemMode m, int64_t nowMs)
+    {
+        const int64_t start = k_uptime_get();
+        auto r = m_D.SwitchSystemMode(m);
+        const uint32_t took = uint32_t(k_uptime_get() - start);
+        if (!r)
+        {
+            ++m_Stats.failures;
+            m_RetryAtMs = nowMs + m_Cfg.retryMs;
+            return r;
+        }
+        ++m_Stats.switches;
+        m_Stats.lastSwitchMs = took;
+        m_Stats.maxSwitchMs = std::max(m_Stats.maxSwitchMs, took);
+        //the switch itself is accounted to the mode it left
+        Account(nowMs + took);
+        if (m == SystemMode::Simple)
+            m_SimpleSinceMs = m_LastEnergyMs = nowMs + took;
+        return r;
+    }
+
+    LD2412ModePolicy::ExpectedResult LD2412ModePolicy::Update(int64_t nowMs)
+    {
+        if (!m_Started)
+        {
+            m_Started = true;
+            m_Mode = m_D.GetSystemMode();
+            m_AccountedMs = nowMs;
+            m_SimpleSinceMs = nowMs - m_Cfg.minSimpleMs;
+            m_LastEnergyMs = nowMs;
+            m_LastState = m_D.GetPresence().m_State;
+        }
+        Account(nowMs);
+
+        PresenceResult const p = m_D.GetPresence();
+        const bool energy = m_Mode == SystemMode::Energy;
+        const bool flapping = Flapping(p, nowMs);
+        if (uint32_t ms = m_Requested.exchange(0, std::memory_order_relaxed))
+            Trigger(Reason::Demand, nowMs, nowMs + ms);
+        if (energy || nowMs - m_SimpleSinceMs >= m_Cfg.minSimpleMs)
+        {
+            const int64_t until = nowMs + m_Cfg.holdMs;
+            if (m_Cfg.ambiguousEnergy && ambiguous(p, m_Cfg.ambiguousEnergy))
+                Trigger(Reason::Ambiguous, nowMs, until);
+            if (flapping)
+                Trigger(Reason::Flapping, nowMs, until);
+            if (m_Cfg.periodicMs && !energy && nowMs - m_LastEnergyMs >= m_Cfg.periodicMs)
+                Trigger(Reason::Periodic, nowMs, until);
+        }
+
+        const SystemMode want = nowMs < m_EnergyUntilMs ? SystemMode::Energy : SystemMode::Simple;
+        if (want == m_Mode || nowMs < m_RetryAtMs)
+            return std::ref(m_D);
+        return Switch(want, nowMs);
+    }
+}
@@ -0,0 +1,80 @@
+#include <nrf_uart/periphery/lib_ld2412_stats.hpp>
+#include <nrf_uart/periphery/lib_ld2412_gates.hpp>
+#include <algorithm>
+
+namespace hlk{
+    LD2412EnergyStats::LD2412EnergyStats(uint16_t windowFrames):
+        m_Window(std::max<uint16_t>(windowFrames, 1))
+    {
+        Reset();
+    }
+
+    void LD2412EnergyStats::SetWindow(uint16_t frames)
+    {
+        m_Window = std::max<uint16_t>(frames, 1);
+        Reset();
+    }
+
+    void LD2412EnergyStats::Reset()
+    {
+        m_N = 0;
+        for(auto *pAcc : {&m_Move, &m_Still})
+        {
+            pAcc->min.fill(0xff);
+            pAcc->max.fill(0);
+            pAcc->sum.fill(0);
+            pAcc->sumSq.fill(0);
+        }
+    }
+
+    void LD2412EnergyStats::Fold(Acc &acc, LD2412::gate_array_t const& v)
+    {
+        acc.min = gates::min(acc.min, v);
+        acc.max = gates::max(acc.max, v);
+        for(size_t g = 0; g < v.size(); ++g)
+        {
+            uint8_t e = v[g];
+            acc.sum[g] += e;
+            acc.sumSq[g] += uint32_t(e) * e;
+        }
+    }
+
+    void LD2412EnergyStats::Finish(Acc const& acc, uint16_t n, energy_stat_array_t &dst)
+    {
+        if (!n)
+        {
+            dst = {};
+            return;
+        }
+        const uint64_t n2 = uint64_t(n) * n;
+        for(size_t g = 0; g < dst.size(); ++g)
+        {
+            uint32_t sum = acc.sum[g];
+            //var = (n*sum(x^2) - sum(x)^2) / n^2, never negative in integers
+            uint64_t num = uint64_t(n) * acc.sumSq[g] - uint64_t(sum) * sum;
+            dst[g].min = acc.min[g];
+            dst[g].max = acc.max[g];
+            dst[g].avg = uint8_t((sum + n / 2) / n);
+            dst[g].var = uint16_t(std::min<uint64_t>((num + n2 / 2) / n2, UINT16_MAX));
+        }
+    }
+
+    void LD2412EnergyStats::Add(Engeneering const& e)
+    {
+        Fold(m_Move, e.m_MoveEnergy);
+        Fold(m_Still, e.m_StillEnergy);
+        if (++m_N < m_Window)
+            return;
+        m_Last.Publish(GetCurrent());
+        Reset();
+    }
+
+    auto LD2412EnergyStats::GetCurrent() const -> Window
+    {
+        Window w;
+        w.frames = m_N;
+        Finish(m_Move, m_N, w.move);
+        Finish(m_Still, m_N, w.still);
+        return w;
+    }
+}
@@ -0,0 +1,261 @@
+#include <nrf_uart/periphery/lib_ld2412_wire.hpp>
+#include <cstring>
+#include <bit>
+
+namespace hlk{
+    namespace wire
+    {
+        namespace
+        {
+            using gate_array_t = LD2412::gate_array_t;
+
+            constexpr uint8_t kStateMask = 0x07;
+            constexpr uint8_t kEngineering = 0x08;
+            constexpr uint8_t kKeyframe = 0x10;
+            constexpr uint8_t kVersionShift = 5;
+            constexpr uint16_t kNibbles = 0x8000;
+            constexpr uint16_t kGateMask = (1 << LD2412::kGateCount) - 1;
+
+            uint32_t zigzag(int32_t v) { return (uint32_t(v) << 1) ^ uint32_t(v >> 31); }
+            int32_t unzigzag(uint32_t v) { return int32_t(v >> 1) ^ -int32_t(v & 1); }
+
+            size_t put_varint(uint8_t *p, uint32_t v)
+            {
+                size_t n = 0;
+                do
+                {
+                    uint8_t b = v & 0x7f;
+                    v >>= 7;
+                    p[n++] = b | (v ? 0x80 : 0);
+                }while(v);
+                return n;
+            }
+
+            bool get_varint(const uint8_t *&p, const uint8_t *pEnd, uint32_t &v)
+            {
+                v = 0;
+                for(int shift = 0; shift < 21 && p < pEnd; shift += 7)
+                {
+                    uint8_t b = *p++;
+                    v |= uint32_t(b & 0x7f) << shift;
+                    if (!(b & 0x80))
+                        return true;
+                }
+                return false;
+            }
+
+            size_t put_distance(uint8_t *p, uint16_t v, uint16_t &ref)
+            {
+                size_t n = put_varint(p, zigzag(int32_t(v) - ref));
+                ref = v;
+                return n;
+            }
+
+            //0 - ok, 1 - truncated, 2 - malformed (see to_error)
+            int get_distance(const uint8_t *&p, const uint8_t *pEnd, uint16_t &ref)
+            {
+                uint32_t z;
+                if (!get_varint(p, pEnd, z))
+                    return p == pEnd ? 1 : 2;
+                int32_t v = int32_t(ref) + unzigzag(z);
+                if (v < 0 || v > UINT16_MAX)
+                    return 2;
+                ref = uint16_t(v);
+                return 0;
+            }
+
+            constexpr uint8_t kEscape = 0x08;//nibble: the new value is in the trailing bytes
+
+            bool fits_nibble(int d) { return d >= -7 && d <= 7; }
+
+            size_t put_gates(uint8_t *p, gate_array_t const& cur, gate_array_t &ref)
+            {
+                uint16_t mask = 0;
+                size_t changed = 0, escapes = 0;
+                for(uint8_t g = 0; g < LD2412::kGateCount; ++g)
+                {
+                    int d = int(cur[g]) - ref[g];
+                    if (!d)
+                        continue;
+                    mask |= 1 << g;
+                    ++changed;
+                    escapes += !fits_nibble(d);
+                }
+                size_t n = 2;
+                const size_t nibbleBytes = (changed + 1) / 2;
+                if (changed && nibbleBytes + escapes < changed)
+                {
+                    //two deltas per byte, low nibble first, then the escaped values
+                    uint8_t *pEsc = p + n + nibbleBytes;
+                    uint8_t i = 0;
+                    for(uint8_t g = 0; g < LD2412::kGateCount; ++g)
+                    {
+                        if (!(mask & (1 << g)))
+                            continue;
+                        int d = int(cur[g]) - ref[g];
+                        uint8_t nib = kEscape;
+                        if (fits_nibble(d))
+                            nib = uint8_t(d) & 0x0f;
+                        else
+                            *pEsc++ = cur[g];
+                        if (i & 1)
+                            p[n++] |= nib << 4;
+                        else
+                            p[n] = nib;
+                        ++i;
+                    }
+                    n = size_t(pEsc - p);
+                    mask |= kNibbles;
+                }else
+                {
+                    for(uint8_t g = 0; g < LD2412::kGateCount; ++g)
+                        if (mask & (1 << g))
+                            p[n++] = cur[g];
+                }
+                p[0] = uint8_t(mask);
+                p[1] = uint8_t(mask >> 8);
+                ref = cur;
+                return n;
+            }
+
+            //0 - ok, 1 - truncated, 2 - malformed
+            int get_gates(const uint8_t *&p, const uint8_t *pEnd, gate_array_t &ref)
+            {
+                if (pEnd - p < 2)
+                    return 1;
+                uint16_t mask = uint16_t(p[0] | (p[1] << 8));
+                p += 2;
+                if (mask & ~(kGateMask | kNibbles))
+                    return 2;
+                const size_t changed = size_t(std::popcount(uint16_t(mask & kGateMask)));
+                if (!(mask & kNibbles))
+                {
+                    if (size_t(pEnd - p) < changed)
+                        return 1;
+                    for(uint8_t g = 0; g < LD2412::kGateCount; ++g)
+                        if (mask & (1 << g))
+                            ref[g] = *p++;
+                    return 0;
+                }
+                const size_t nibbleBytes = (changed + 1) / 2;
+                if (size_t(pEnd - p) < nibbleBytes)
+                    return 1;
+                const uint8_t *pEsc = p + nibbleBytes;
+                gate_array_t r = ref;
+                uint8_t i = 0;
+                for(uint8_t g = 0; g < LD2412::kGateCount; ++g)
+                {
+                    if (!(mask & (1 << g)))
+                        continue;
+                    uint8_t nib = (i & 1 ? p[i / 2] >> 4 : p[i / 2]) & 0x0f;
+                    ++i;
+                    if (nib == kEscape)
+                    {
+                        if (pEsc == pEnd)
+                            return 1;
+                        r[g] = *pEsc++;
+                    }else
+                        r[g] = uint8_t(r[g] + (int8_t(nib << 4) >> 4));
+                }
+                ref = r;
+                p = pEsc;
+                return 0;
+            }
+
+            Error to_error(int r) { return r == 1 ? Error::Truncated : Error::Malformed; }
+        }
+
+        size_t Encoder::Encode(std::span<uint8_t> dst, PresenceResult const& p, Engeneering const* pEng)
+        {
+            //built aside, so a too small dst leaves the reference alone
+            uint8_t buf[kMaxFrame];
+            Reference ref = m_Keyframe ? Reference{} : m_Ref;
+            buf[0] = uint8_t((uint8_t(p.m_State) & kStateMask) | (pEng ? kEngineering : 0) | (m_Keyframe ? kKeyframe : 0) | (kVersion << kVersionShift));
+            buf[1] = m_Seq;
+            size_t n = 2;
+            n += put_distance(buf + n, p.m_MoveDistance, ref.moveDistance);
+            n += put_distance(buf + n, p.m_StillDistance, ref.stillDistance);
+            buf[n++] = p.m_MoveEnergy;
+            buf[n++] = p.m_StillEnergy;
+            if (pEng)
+            {
+                buf[n++] = uint8_t((pEng->m_MaxMoveGate & 0x0f) | (pEng->m_MaxStillGate << 4));
+                buf[n++] = pEng->m_Light;
+                n += put_gates(buf + n, pEng->m_MoveEnergy, ref.move);
+                n += put_gates(buf + n, pEng->m_StillEnergy, ref.still);
+            }
+            if (n > dst.size())
+                return 0;
+            std::memcpy(dst.data(), buf, n);
+
+            m_Ref = ref;
+            ++m_Seq;
+            if (m_Keyframe)
+                m_SinceKeyframe = 0;
+            m_Keyframe = m_KeyframeInterval && ++m_SinceKeyframe >= m_KeyframeInterval;
+            return n;
+        }
+
+        size_t Encoder::Encode(std::span<uint8_t> dst, LD2412::frame_snapshot_t const& f)
+        {
+            return Encode(dst, f.value.m_Presence, f.value.m_Mode == LD2412::SystemMode::Energy ? &f.value.m_Engeneering : nullptr);
+        }
+
+        std::expected<Frame, Error> Decoder::Decode(std::span<const uint8_t> src, size_t *pUsed)
+        {
+            const uint8_t *p = src.data();
+            const uint8_t *pEnd = p + src.size();
+            if (src.size() < 2)
+                return std::unexpected(Error::Truncated);
+            const uint8_t flags = p[0];
+            Frame f{};
+            f.seq = p[1];
+            f.keyframe = flags & kKeyframe;
+            f.hasEngineering = flags & kEngineering;
+            if ((flags >> kVersionShift) != kVersion || (flags & kStateMask) > uint8_t(LD2412::TargetState::BackgroundAnalysisFailed))
+                return std::unexpected(Error::Malformed);
+            f.presence.m_State = LD2412::TargetState(flags & kStateMask);
+            p += 2;
+
+            Reference ref = f.keyframe ? Reference{} : m_Ref;
+            if (int r = get_distance(p, pEnd, ref.moveDistance); r)
+                return std::unexpected(to_error(r));
+            if (int r = get_distance(p, pEnd, ref.stillDistance); r)
+                return std::unexpected(to_error(r));
+            if (pEnd - p < 2)
+                return std::unexpected(Error::Truncated);
+            f.presence.m_MoveDistance = ref.moveDistance;
+            f.presence.m_StillDistance = ref.stillDistance;
+            f.presence.m_MoveEnergy = *p++;
+            f.presence.m_StillEnergy = *p++;
+            if (f.hasEngineering)
+            {
+                if (pEnd - p < 2)
+                    return std::unexpected(Error::Truncated);
+                f.engineering.m_MaxMoveGate = *p & 0x0f;
+                f.engineering.m_MaxStillGate = *p++ >> 4;
+                f.engineering.m_Light = *p++;
+                if (f.engineering.m_MaxMoveGate > LD2412::kMaxGate || f.engineering.m_MaxStillGate > LD2412::kMaxGate)
+                    return std::unexpected(Error::Malformed);
+                if (int r = get_gates(p, pEnd, ref.move); r)
+                    return std::unexpected(to_error(r));
+                if (int r = get_gates(p, pEnd, ref.still); r)
+                    return std::unexpected(to_error(r));
+                f.engineering.m_MoveEnergy = ref.move;
+                f.engineering.m_StillEnergy = ref.still;
+            }
+            if (pUsed)
+                *pUsed = size_t(p - src.data());
+
+            if (!f.keyframe && (!m_Synced || f.seq != uint8_t(m_Seq + 1)))
+            {
+                m_Synced = false;
+                return std::unexpected(Error::NeedKeyframe);
+            }
+            m_Ref = ref;
+            m_Seq = f.seq;
+            m_Synced = true;
+            return f;
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#include <nrf_uart/periphery/lib_ld2412_zones.hpp>
+#include <nrf_uart/periphery/lib_ld2412_gates.hpp>
+
+namespace hlk{
+    namespace
+    {
+        LD2412::TargetState to_state(bool move, bool still)
+        {
+            using TargetState = LD2412::TargetState;
+            if (move && still)
+                return TargetState::MoveAndStill;
+            if (move)
+                return TargetState::Move;
+            if (still)
+                return TargetState::Still;
+            return TargetState::Clear;
+        }
+
+        //latches a detection for holdMs after the last frame that had it
+        bool hold(bool hit, bool on, int64_t &last, int64_t now, uint16_t holdMs)
+        {
+            if (hit)
+            {
+                last = now;
+                return true;
+            }
+            return on && (now - last) < holdMs;
+        }
+    }
+
+    bool LD2412Zones::AddZone(Zone const& z)
+    {
+        if (m_Count == kMaxZones || z.firstGate > z.lastGate || z.lastGate > LD2412::kMaxGate)
+            return false;
+        ZoneState &s = m_Zones[m_Count];
+        s = ZoneState{};
+        s.cfg = z;
+        s.moveThr.fill(0xff);
+        s.stillThr.fill(0xff);
+        for(uint8_t g = z.firstGate; g <= z.lastGate; ++g)
+        {
+            s.moveThr[g] = z.moveThreshold;
+            s.stillThr[g] = z.stillThreshold;
+        }
+        ++m_Count;
+        return true;
+    }
+
+    uint8_t LD2412Zones::Add(Engeneering const& e, int64_t nowMs)
+    {
+        uint8_t changed = 0;
+        m_EventCount = 0;
+        for(uint8_t i = 0; i < m_Count; ++i)
+        {
+            ZoneState &s = m_Zones[i];
+            uint16_t moveGates = gates::above(e.m_MoveEnergy, s.moveThr);
+            uint16_t stillGates = gates::above(e.m_StillEnergy, s.stillThr);
+            s.move = hold(moveGates != 0, s.move, s.lastMoveMs, nowMs, s.cfg.holdMs);
+            s.still = hold(stillGates != 0, s.still, s.lastStillMs, nowMs, s.cfg.holdMs);
+            TargetState st = to_state(s.move, s.still);
+            if (st == s.state)
+                continue;
+            Event &ev = m_Events[m_EventCount++];
+            ev = Event{nowMs, i, s.state, st, moveGates, stillGates};
+            s.state = st;
+            changed |= 1 << i;
+            if (m_pQueue)
+                m_pQueue->Push(ev);
+        }
+        return changed;
+    }
+
+    uint8_t LD2412Zones::Add(LD2412::frame_snapshot_t const& f)
+    {
+        if (f.value.m_Mode != LD2412::SystemMode::Energy)
+            return 0;
+        return Add(f.value.m_Engeneering, f.uptimeMs);
+    }
+}